@@ -0,0 +1,463 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+
+#include <sstmac/backends/common/graph_partition.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <set>
+#include <utility>
+
+namespace sstmac {
+
+int64_t
+GraphPartitioner::Graph::totalWeight() const
+{
+  int64_t total = 0;
+  for (int64_t w : vwgt) total += w;
+  return total;
+}
+
+GraphPartitioner::GraphPartitioner(double imbalance) :
+  imbalance_(imbalance)
+{
+}
+
+int64_t
+GraphPartitioner::edgeCut(const Graph& g, const std::vector<int>& part)
+{
+  int64_t cut = 0;
+  for (int v=0; v < g.numVertices(); ++v){
+    for (int j=g.xadj[v]; j < g.xadj[v+1]; ++j){
+      if (part[g.adjncy[j]] != part[v]) cut += g.adjwgt[j];
+    }
+  }
+  //every cut edge was counted from both sides
+  return cut / 2;
+}
+
+GraphPartitioner::Graph
+GraphPartitioner::subgraph(const Graph& g, const std::vector<int>& part, int p,
+                           std::vector<int>& vertices)
+{
+  int n = g.numVertices();
+  std::vector<int> new_index(n, -1);
+  vertices.clear();
+  for (int v=0; v < n; ++v){
+    if (part[v] == p){
+      new_index[v] = vertices.size();
+      vertices.push_back(v);
+    }
+  }
+
+  Graph sub;
+  sub.xadj.push_back(0);
+  for (int v : vertices){
+    sub.vwgt.push_back(g.vwgt[v]);
+    for (int j=g.xadj[v]; j < g.xadj[v+1]; ++j){
+      int u = new_index[g.adjncy[j]];
+      if (u >= 0){
+        sub.adjncy.push_back(u);
+        sub.adjwgt.push_back(g.adjwgt[j]);
+      }
+    }
+    sub.xadj.push_back(sub.adjncy.size());
+  }
+  return sub;
+}
+
+void
+GraphPartitioner::partition(const Graph& g, int nparts, std::vector<int>& part)
+{
+  int n = g.numVertices();
+  part.assign(n, 0);
+  if (nparts <= 1 || n == 0) return;
+
+  //imbalance compounds through each level of bisection
+  int nlevels = 0;
+  while ((1 << nlevels) < nparts) ++nlevels;
+  double imbalance = std::pow(imbalance_, 1.0 / nlevels);
+
+  std::vector<int> vertices(n);
+  for (int v=0; v < n; ++v) vertices[v] = v;
+  recursiveBisect(g, nparts, 0, imbalance, vertices, part);
+}
+
+void
+GraphPartitioner::recursiveBisect(const Graph& g, int nparts, int first_part, double imbalance,
+                                  const std::vector<int>& vertices, std::vector<int>& part)
+{
+  if (nparts == 1){
+    for (int v : vertices) part[v] = first_part;
+    return;
+  }
+  if (g.numVertices() == 0) return;
+
+  int nparts0 = nparts / 2;
+  int nparts1 = nparts - nparts0;
+  std::vector<int> where;
+  bisect(g, double(nparts0) / nparts, imbalance, where);
+
+  for (int side=0; side < 2; ++side){
+    std::vector<int> sub_vertices;
+    Graph sub = subgraph(g, where, side, sub_vertices);
+    for (int& v : sub_vertices) v = vertices[v];
+    if (side == 0){
+      recursiveBisect(sub, nparts0, first_part, imbalance, sub_vertices, part);
+    } else {
+      recursiveBisect(sub, nparts1, first_part + nparts0, imbalance, sub_vertices, part);
+    }
+  }
+}
+
+void
+GraphPartitioner::bisect(const Graph& g, double frac0, double imbalance, std::vector<int>& where)
+{
+  int64_t total = g.totalWeight();
+  int64_t max_vertex = *std::max_element(g.vwgt.begin(), g.vwgt.end());
+  int64_t target[2];
+  target[0] = int64_t(frac0 * total + 0.5);
+  target[1] = total - target[0];
+  int64_t maxw[2];
+  for (int s=0; s < 2; ++s){
+    maxw[s] = std::max(int64_t(target[s] * imbalance), target[s]);
+  }
+
+  //coarsen until the graph is small or matching stops making progress
+  int64_t max_coarse_vertex = std::max(max_vertex, int64_t(1.5 * total / coarsen_to_));
+  std::vector<Graph> levels;
+  std::vector<std::vector<int>> cmaps;
+  const Graph* current = &g;
+  while (current->numVertices() > coarsen_to_){
+    Graph coarse;
+    std::vector<int> cmap;
+    coarsen(*current, max_coarse_vertex, coarse, cmap);
+    if (coarse.numVertices() > 0.95 * current->numVertices()) break;
+    levels.push_back(std::move(coarse));
+    cmaps.push_back(std::move(cmap));
+    current = &levels.back();
+  }
+
+  initialBisection(*current, maxw, target[0], where);
+
+  //project back through each level, refining as we go
+  for (int level=levels.size() - 1; level >= 0; --level){
+    const Graph& fine = level == 0 ? g : levels[level-1];
+    const std::vector<int>& cmap = cmaps[level];
+    std::vector<int> fine_where(fine.numVertices());
+    for (int v=0; v < fine.numVertices(); ++v){
+      fine_where[v] = where[cmap[v]];
+    }
+    refine(fine, maxw, fine_where);
+    where = std::move(fine_where);
+  }
+}
+
+void
+GraphPartitioner::coarsen(const Graph& g, int64_t max_vwgt, Graph& coarse, std::vector<int>& cmap)
+{
+  int n = g.numVertices();
+
+  //visit low-degree vertices first so they are not left without a partner
+  std::vector<int> order(n);
+  for (int v=0; v < n; ++v) order[v] = v;
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b){
+    return (g.xadj[a+1] - g.xadj[a]) < (g.xadj[b+1] - g.xadj[b]);
+  });
+
+  //heavy-edge matching
+  std::vector<int> match(n, -1);
+  for (int v : order){
+    if (match[v] >= 0) continue;
+    int partner = v;
+    int64_t heaviest = -1;
+    for (int j=g.xadj[v]; j < g.xadj[v+1]; ++j){
+      int u = g.adjncy[j];
+      if (match[u] < 0 && u != v && g.adjwgt[j] > heaviest
+          && g.vwgt[v] + g.vwgt[u] <= max_vwgt){
+        partner = u;
+        heaviest = g.adjwgt[j];
+      }
+    }
+    match[v] = partner;
+    match[partner] = v;
+  }
+
+  cmap.assign(n, -1);
+  std::vector<int> leader;
+  for (int v=0; v < n; ++v){
+    if (cmap[v] < 0){
+      cmap[v] = cmap[match[v]] = leader.size();
+      leader.push_back(v);
+    }
+  }
+
+  int nc = leader.size();
+  coarse.xadj.clear();
+  coarse.adjncy.clear();
+  coarse.adjwgt.clear();
+  coarse.vwgt.assign(nc, 0);
+  coarse.xadj.push_back(0);
+  //position of each coarse neighbor in the adjacency list being built
+  std::vector<int> position(nc, -1);
+  for (int c=0; c < nc; ++c){
+    int v = leader[c];
+    int members[] = { v, match[v] };
+    int nmembers = match[v] == v ? 1 : 2;
+    int start = coarse.adjncy.size();
+    for (int m=0; m < nmembers; ++m){
+      int w = members[m];
+      coarse.vwgt[c] += g.vwgt[w];
+      for (int j=g.xadj[w]; j < g.xadj[w+1]; ++j){
+        int cu = cmap[g.adjncy[j]];
+        if (cu == c) continue;
+        if (position[cu] < 0){
+          position[cu] = coarse.adjncy.size();
+          coarse.adjncy.push_back(cu);
+          coarse.adjwgt.push_back(g.adjwgt[j]);
+        } else {
+          coarse.adjwgt[position[cu]] += g.adjwgt[j];
+        }
+      }
+    }
+    for (int j=start; j < int(coarse.adjncy.size()); ++j){
+      position[coarse.adjncy[j]] = -1;
+    }
+    coarse.xadj.push_back(coarse.adjncy.size());
+  }
+}
+
+static int64_t
+overweight(const int64_t pwgt[2], const int64_t maxw[2])
+{
+  return std::max(int64_t(0), pwgt[0] - maxw[0]) + std::max(int64_t(0), pwgt[1] - maxw[1]);
+}
+
+void
+GraphPartitioner::initialBisection(const Graph& g, const int64_t maxw[2], int64_t target0,
+                                   std::vector<int>& where)
+{
+  int n = g.numVertices();
+  int ntrials = n < num_initial_trials_ ? n : num_initial_trials_;
+  int64_t best_cut = std::numeric_limits<int64_t>::max();
+  int64_t best_over = std::numeric_limits<int64_t>::max();
+  std::vector<int> trial(n);
+  std::vector<bool> visited(n);
+  std::vector<int64_t> gain(n);
+  //ordered by highest gain, then lowest vertex id
+  std::set<std::pair<int64_t,int>> frontier;
+  for (int t=0; t < ntrials; ++t){
+    //greedily grow side 0 from a different seed each trial,
+    //always adding the vertex that most reduces the cut
+    std::fill(trial.begin(), trial.end(), 1);
+    std::fill(visited.begin(), visited.end(), false);
+    frontier.clear();
+    int seed = int64_t(t) * n / ntrials;
+    int next_unvisited = 0;
+    int64_t pwgt0 = 0;
+    while (pwgt0 < target0){
+      if (frontier.empty()){
+        //the graph might not be connected
+        if (visited[seed]){
+          while (next_unvisited < n && visited[next_unvisited]) ++next_unvisited;
+          if (next_unvisited == n) break;
+          seed = next_unvisited;
+        }
+        visited[seed] = true;
+        gain[seed] = 0;
+        frontier.emplace(0, seed);
+      }
+      int v = frontier.begin()->second;
+      frontier.erase(frontier.begin());
+      trial[v] = 0;
+      pwgt0 += g.vwgt[v];
+      for (int j=g.xadj[v]; j < g.xadj[v+1]; ++j){
+        int u = g.adjncy[j];
+        if (trial[u] == 0) continue;
+        if (visited[u]){
+          frontier.erase(std::make_pair(-gain[u], u));
+          gain[u] += 2*g.adjwgt[j];
+        } else {
+          visited[u] = true;
+          gain[u] = 2*g.adjwgt[j];
+          for (int k=g.xadj[u]; k < g.xadj[u+1]; ++k) gain[u] -= g.adjwgt[k];
+        }
+        frontier.emplace(-gain[u], u);
+      }
+    }
+
+    refine(g, maxw, trial);
+
+    int64_t pwgt[2] = {0, 0};
+    for (int v=0; v < n; ++v) pwgt[trial[v]] += g.vwgt[v];
+    int64_t over = overweight(pwgt, maxw);
+    int64_t cut = edgeCut(g, trial);
+    if (over < best_over || (over == best_over && cut < best_cut)){
+      best_over = over;
+      best_cut = cut;
+      where = trial;
+    }
+  }
+}
+
+void
+GraphPartitioner::refine(const Graph& g, const int64_t maxw[2], std::vector<int>& where)
+{
+  int n = g.numVertices();
+  std::vector<int64_t> internal(n), external(n);
+  std::vector<bool> locked(n);
+  //ordered by highest gain, then lowest vertex id
+  typedef std::set<std::pair<int64_t,int>> bucket;
+  bucket buckets[2];
+  std::vector<int> moves;
+  int64_t max_vertex = *std::max_element(g.vwgt.begin(), g.vwgt.end());
+
+  for (int pass=0; pass < max_refine_passes_; ++pass){
+    int64_t pwgt[2] = {0, 0};
+    int64_t cut = 0;
+    buckets[0].clear();
+    buckets[1].clear();
+    for (int v=0; v < n; ++v){
+      pwgt[where[v]] += g.vwgt[v];
+      internal[v] = external[v] = 0;
+      for (int j=g.xadj[v]; j < g.xadj[v+1]; ++j){
+        if (where[g.adjncy[j]] == where[v]) internal[v] += g.adjwgt[j];
+        else external[v] += g.adjwgt[j];
+      }
+      cut += external[v];
+      locked[v] = false;
+      if (external[v] > 0){
+        buckets[where[v]].emplace(internal[v] - external[v], v);
+      }
+    }
+    cut /= 2;
+
+    moves.clear();
+    int64_t best_cut = cut;
+    int64_t best_over = overweight(pwgt, maxw);
+    int best_nmoves = 0;
+    while (moves.size() - best_nmoves < max_bad_moves_){
+      //find the best move from each side that does not break the balance
+      int candidate[2] = {-1, -1};
+      for (int s=0; s < 2; ++s){
+        int other = 1 - s;
+        int tries = 0;
+        for (auto iter=buckets[s].begin(); iter != buckets[s].end() && tries < 16; ++iter, ++tries){
+          int v = iter->second;
+          int64_t new_other = pwgt[other] + g.vwgt[v];
+          //allow overshooting by one vertex so that vertices can be swapped
+          bool ok = pwgt[s] > maxw[s]
+              ? new_other - maxw[other] < pwgt[s] - maxw[s]
+              : new_other <= maxw[other] + max_vertex;
+          if (ok){
+            candidate[s] = v;
+            break;
+          }
+        }
+      }
+      //an overweight side must shed vertices
+      if (pwgt[0] > maxw[0]) candidate[1] = -1;
+      else if (pwgt[1] > maxw[1]) candidate[0] = -1;
+
+      int from;
+      if (candidate[0] < 0 && candidate[1] < 0){
+        break;
+      } else if (candidate[0] < 0){
+        from = 1;
+      } else if (candidate[1] < 0){
+        from = 0;
+      } else {
+        int v0 = candidate[0], v1 = candidate[1];
+        from = (external[v1] - internal[v1]) > (external[v0] - internal[v0]) ? 1 : 0;
+      }
+      int to = 1 - from;
+      int v = candidate[from];
+
+      buckets[from].erase(std::make_pair(internal[v] - external[v], v));
+      locked[v] = true;
+      where[v] = to;
+      pwgt[from] -= g.vwgt[v];
+      pwgt[to] += g.vwgt[v];
+      cut -= external[v] - internal[v];
+      std::swap(internal[v], external[v]);
+      for (int j=g.xadj[v]; j < g.xadj[v+1]; ++j){
+        int u = g.adjncy[j];
+        int64_t w = g.adjwgt[j];
+        auto old_key = std::make_pair(internal[u] - external[u], u);
+        if (where[u] == to){
+          internal[u] += w;
+          external[u] -= w;
+        } else {
+          internal[u] -= w;
+          external[u] += w;
+        }
+        if (!locked[u]){
+          buckets[where[u]].erase(old_key);
+          if (external[u] > 0){
+            buckets[where[u]].emplace(internal[u] - external[u], u);
+          }
+        }
+      }
+      moves.push_back(v);
+
+      int64_t over = overweight(pwgt, maxw);
+      if (over < best_over || (over == best_over && cut < best_cut)){
+        best_over = over;
+        best_cut = cut;
+        best_nmoves = moves.size();
+      }
+    }
+
+    //undo everything after the best point in the pass
+    for (int i=moves.size() - 1; i >= best_nmoves; --i){
+      int v = moves[i];
+      where[v] = 1 - where[v];
+    }
+    if (best_nmoves == 0) break;
+  }
+}
+
+}
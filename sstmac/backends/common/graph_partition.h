@@ -0,0 +1,138 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+
+#ifndef SSTMAC_BACKENDS_COMMON_GRAPH_PARTITION_H_INCLUDED
+#define SSTMAC_BACKENDS_COMMON_GRAPH_PARTITION_H_INCLUDED
+
+#include <vector>
+#include <cstdint>
+
+namespace sstmac {
+
+/**
+ * @brief The GraphPartitioner class
+ * Multilevel k-way partitioning of a weighted, undirected graph by recursive bisection.
+ * Each bisection coarsens the graph with heavy-edge matching, splits the coarsest graph
+ * by graph growing, and then refines the split with Fiduccia-Mattheyses passes
+ * while projecting it back to the original graph.
+ * The result is deterministic so that every rank computes the same partition.
+ */
+class GraphPartitioner
+{
+ public:
+  /**
+   * @brief The Graph struct
+   * Compressed sparse row adjacency. Each undirected edge appears
+   * once in the adjacency list of each of its two vertices.
+   */
+  struct Graph {
+    std::vector<int> xadj;
+    std::vector<int> adjncy;
+    std::vector<int64_t> adjwgt;
+    std::vector<int64_t> vwgt;
+
+    int numVertices() const {
+      return vwgt.size();
+    }
+
+    int64_t totalWeight() const;
+  };
+
+  /**
+   * @param imbalance The maximum allowed ratio of a part weight to its target weight
+   */
+  explicit GraphPartitioner(double imbalance);
+
+  /**
+   * @brief partition
+   * @param g The graph to partition
+   * @param nparts The number of parts
+   * @param part [out] The part in [0,nparts) of each vertex
+   */
+  void partition(const Graph& g, int nparts, std::vector<int>& part);
+
+  /**
+   * @brief subgraph Extract the graph induced by all vertices in a given part
+   * @param g The full graph
+   * @param part The part of each vertex in g
+   * @param p The part to extract
+   * @param vertices [out] The vertex in g of each vertex in the subgraph
+   * @return The induced subgraph
+   */
+  static Graph subgraph(const Graph& g, const std::vector<int>& part, int p,
+                        std::vector<int>& vertices);
+
+  /**
+   * @return The total weight of edges whose endpoints are in different parts
+   */
+  static int64_t edgeCut(const Graph& g, const std::vector<int>& part);
+
+ private:
+  void recursiveBisect(const Graph& g, int nparts, int first_part, double imbalance,
+                       const std::vector<int>& vertices, std::vector<int>& part);
+
+  void bisect(const Graph& g, double frac0, double imbalance, std::vector<int>& where);
+
+  void coarsen(const Graph& g, int64_t max_vwgt, Graph& coarse, std::vector<int>& cmap);
+
+  void initialBisection(const Graph& g, const int64_t maxw[2], int64_t target0,
+                        std::vector<int>& where);
+
+  void refine(const Graph& g, const int64_t maxw[2], std::vector<int>& where);
+
+  double imbalance_;
+
+  static constexpr int coarsen_to_ = 64;
+
+  static constexpr int num_initial_trials_ = 8;
+
+  static constexpr int max_refine_passes_ = 8;
+
+  static constexpr int max_bad_moves_ = 64;
+};
+
+}
+
+#endif
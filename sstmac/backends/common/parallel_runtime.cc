@@ -52,6 +52,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sprockit/fileio.h>
 #include <fstream>
 #include <sstream>
+#include <cstring>
 #include <sprockit/keyword_registration.h>
 #include <sprockit/thread_safe.h>
 #include <sprockit/printable.h>
@@ -312,55 +313,69 @@ ParallelRuntime::~ParallelRuntime()
 
 #if !SSTMAC_INTEGRATED_SST_CORE
 void
-ParallelRuntime::runSerialize(serializer& ser, IpcEvent* iev)
+ParallelRuntime::unpackEvent(char* buf, IpcEvent* iev)
 {
-  ser & iev->ser_size; //this must be first!!!
-  ser & iev->thread; //this must be first!!!
-  ser & iev->t;
-  ser & iev->seqnum;
-  ser & iev->link;
-  ser & iev->rank;
-  ser & iev->ev;
+  ::memcpy(static_cast<IpcEventBase*>(iev), buf, sizeof(IpcEventBase));
+  char* payload = buf + sizeof(IpcEventBase);
+  if (iev->wire_type == IpcWire::Serialized){
+    sprockit::serializer ser;
+    ser.start_unpacking(payload, iev->ser_size - sizeof(IpcEventBase));
+    ser & iev->ev;
+  } else {
+    iev->ev = IpcWire::unpack(iev->wire_type, payload);
+  }
 }
 
 void ParallelRuntime::sendEvent(IpcEvent* iev)
 {
-  //somehow this doesn't return the sum of sizes
-  //uint32_t overhead = sizeof(ipc_event_base);
-  constexpr uint32_t overhead =
-      sizeof(uint32_t) //ser_size
-    + sizeof(Timestamp) //t
-    + sizeof(uint32_t) //seqnum
-    + sizeof(uint64_t) //link
-    + sizeof(uint32_t) //rank
-    + sizeof(uint32_t) //thread
-  ;
-
+  //hot event types have a fixed layout that skips the serializer
+  iev->wire_type = iev->ev->ipcWireType();
   sprockit::serializer ser;
-  ser.start_sizing();
-  ser & iev->ev;
-  iev->ser_size = overhead + ser.size();
-  align64(iev->ser_size);
+  if (iev->wire_type == IpcWire::Serialized){
+    ser.start_sizing();
+    ser & iev->ev;
+    iev->ser_size = sizeof(IpcEventBase) + ser.size();
+    align64(iev->ser_size);
+  } else {
+    //keep the next header aligned
+    iev->ser_size = sizeof(IpcEventBase) + iev->ev->ipcWireSize();
+    align8(iev->ser_size);
+  }
+
   CommBuffer& buff = send_buffers_[iev->rank];
   char* ptr = buff.allocateSpace(iev->ser_size, iev);
-  ser.start_packing(ptr, iev->ser_size);
   debug_printf(sprockit::dbg::parallel,
-     "sending event of size %lu to LP %d at t=%10.6e on link=%" PRIu64 " on epoch %d: %s",
-     iev->ser_size, iev->rank, iev->t.sec(), iev->link, epoch_,
+     "sending event of size %lu and wire type %u to LP %d at t=%10.6e on link=%" PRIu64 " on epoch %d: %s",
+     iev->ser_size, iev->wire_type, iev->rank, iev->t.sec(), iev->link, epoch_,
      sprockit::toString(iev->ev).c_str());
-  runSerialize(ser, iev);
+  ::memcpy(ptr, static_cast<IpcEventBase*>(iev), sizeof(IpcEventBase));
+  char* payload = ptr + sizeof(IpcEventBase);
+  if (iev->wire_type == IpcWire::Serialized){
+    ser.start_packing(payload, iev->ser_size - sizeof(IpcEventBase));
+    ser & iev->ev;
+  } else {
+    iev->ev->packWire(payload);
+  }
 
 #if SSTMAC_SANITY_CHECK && !SSTMAC_INTEGRATED_SST_CORE
   IpcEvent test_ev;
-  sprockit::serializer test_ser;
-  test_ser.start_unpacking(ptr, iev->ser_size);
-  runSerialize(test_ser, &test_ev);
+  unpackEvent(ptr, &test_ev);
   iev->ev->validate_serialization(test_ev.ev);
 #endif
 
 }
 #endif
 
+Timestamp
+ParallelRuntime::sendRecvNullMessages(const std::vector<int>& /*sendRanks*/,
+                                      const std::vector<Timestamp>& /*promises*/,
+                                      const std::vector<int>& /*recvRanks*/,
+                                      Timestamp /*vote*/, Timestamp& /*global_vote*/)
+{
+  spkt_abort_printf("parallel runtime does not support null message synchronization");
+  return Timestamp();
+}
+
 void
 ParallelRuntime::resetSendRecv()
 {
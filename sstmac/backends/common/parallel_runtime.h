@@ -68,6 +68,13 @@ void align64(T& t){
   }
 }
 
+template <class T>
+void align8(T& t){
+  if (t % 8){
+    t = t + 8 - t%8;
+  }
+}
+
 template <class T>
 void align64(T*& t){
   intptr_t ptr = (intptr_t) t;
@@ -167,7 +174,12 @@ class ParallelRuntime :
 #if !SSTMAC_INTEGRATED_SST_CORE
   void sendEvent(IpcEvent* iev);
 
-  static void runSerialize(serializer& ser, IpcEvent* iev);
+  /**
+   * @brief unpackEvent Rebuild an event packed by sendEvent
+   * @param buf The start of the IPC header
+   * @param iev [out] The header and a newly allocated event
+   */
+  static void unpackEvent(char* buf, IpcEvent* iev);
 #endif
 
   static const int global_root;
@@ -232,6 +244,24 @@ class ParallelRuntime :
     return vote;
   }
 
+  /**
+   * @brief sendRecvNullMessages
+   * Chandy-Misra-Bryant synchronization between neighboring ranks.
+   * Send the pending events and a null message to each rank this rank has links to,
+   * then receive the same from each rank with links into this rank.
+   * @param sendRanks The ranks this rank has links to
+   * @param promises The earliest time of any future event sent to each of the sendRanks
+   * @param recvRanks The ranks with links into this rank
+   * @param vote The minimum event time I have, reduced across ranks in the background
+   * @param global_vote [inout] The minimum event time across all ranks from the most recently
+   *                    completed vote, unchanged if no vote completed this epoch
+   * @return The minimum promise received, i.e. the time until which this rank can safely run
+   */
+  virtual Timestamp sendRecvNullMessages(const std::vector<int>& sendRanks,
+                                         const std::vector<Timestamp>& promises,
+                                         const std::vector<int>& recvRanks,
+                                         Timestamp vote, Timestamp& global_vote);
+
   void resetSendRecv();
 
   int me() const {
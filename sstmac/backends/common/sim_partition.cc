@@ -51,11 +51,19 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sprockit/util.h>
 #include <sprockit/basic_string_tokenizer.h>
 #include <sprockit/errors.h>
+#include <sprockit/keyword_registration.h>
+#include <sprockit/sim_parameters.h>
 
+#include <algorithm>
 #include <cstring>
+#include <map>
 
 RegisterDebugSlot(partition);
 
+RegisterKeywords(
+{ "partition_imbalance", "for graph partitioning, the maximum ratio of a part's weight to its target weight" }
+);
+
 #define part_debug(...) \
   debug_printf(sprockit::dbg::partition, "Rank %d: %s", me_, sprockit::sprintf(__VA_ARGS__).c_str())
 
@@ -218,4 +226,109 @@ OccupiedBlockPartition::partitionSwitches()
   }
 }
 
+
+GraphPartition::~GraphPartition()
+{
+}
+
+GraphPartition::GraphPartition(SST::Params& params, ParallelRuntime* rt)
+  : BlockPartition(params, rt)
+{
+  imbalance_ = params.find<double>("partition_imbalance", 1.05);
+  if (imbalance_ < 1.0){
+    spkt_abort_printf("partition_imbalance=%f must be at least 1", imbalance_);
+  }
+  buildSwitchGraph(params);
+}
+
+void
+GraphPartition::buildSwitchGraph(SST::Params& params)
+{
+  SST::Params link_params = params.find_scoped_params("switch").find_scoped_params("link");
+  //without link parameters, e.g. for LogP switches, every link counts the same
+  double default_latency = 1.0;
+  if (link_params.contains("latency")){
+    default_latency = link_params.find<SST::UnitAlgebra>("latency").getValue().toDouble();
+  }
+  //every switch link has the same bandwidth, so parallel links add up to the aggregate bandwidth
+  //of an edge; links are scaled down by their latency so that long links are cut first
+  std::map<std::string,int64_t> port_weights;
+  auto link_weight = [&](SwitchId sid, int port){
+    std::string type = fake_top_->portTypeName(sid, port);
+    auto iter = port_weights.find(type);
+    if (iter == port_weights.end()){
+      std::string key = type + "_latency";
+      double latency = default_latency;
+      if (link_params.contains(key)){
+        latency = link_params.find<SST::UnitAlgebra>(key).getValue().toDouble();
+      }
+      int64_t weight = std::max(int64_t(1), int64_t(100 * default_latency / latency + 0.5));
+      iter = port_weights.emplace(type, weight).first;
+    }
+    return iter->second;
+  };
+
+  //links are directed, so accumulate both directions into one undirected edge
+  std::vector<std::map<int,int64_t>> neighbors(num_switches_total_);
+  std::vector<hw::Topology::Connection> conns;
+  for (int i=0; i < num_switches_total_; ++i){
+    fake_top_->connectedOutports(i, conns);
+    for (auto& conn : conns){
+      if (conn.dst == conn.src) continue;
+      int64_t weight = link_weight(conn.src, conn.src_outport);
+      neighbors[conn.src][conn.dst] += weight;
+      neighbors[conn.dst][conn.src] += weight;
+    }
+  }
+
+  std::vector<hw::Topology::InjectionPort> ports;
+  std::vector<NodeId> nodes;
+  graph_.xadj.push_back(0);
+  for (int i=0; i < num_switches_total_; ++i){
+    fake_top_->endpointsConnectedToInjectionSwitch(i, ports);
+    nodes.clear();
+    for (auto& p : ports) nodes.push_back(p.nid);
+    std::sort(nodes.begin(), nodes.end());
+    int num_nodes = std::unique(nodes.begin(), nodes.end()) - nodes.begin();
+    //switches with no nodes still have work routing packets
+    graph_.vwgt.push_back(1 + num_nodes);
+    for (auto& pair : neighbors[i]){
+      graph_.adjncy.push_back(pair.first);
+      graph_.adjwgt.push_back(pair.second);
+    }
+    graph_.xadj.push_back(graph_.adjncy.size());
+  }
+  part_debug("built switch graph with %d switches and %d links",
+             num_switches_total_, int(graph_.adjncy.size() / 2));
+}
+
+void
+GraphPartition::partitionSwitches()
+{
+  GraphPartitioner partitioner(imbalance_);
+  //cuts between ranks are more expensive than cuts between threads, so split across ranks first
+  std::vector<int> rank_part;
+  partitioner.partition(graph_, nproc_, rank_part);
+  for (int rank=0; rank < nproc_; ++rank){
+    std::vector<int> vertices;
+    GraphPartitioner::Graph sub = GraphPartitioner::subgraph(graph_, rank_part, rank, vertices);
+    std::vector<int> thread_part;
+    partitioner.partition(sub, nthread_, thread_part);
+    for (int v=0; v < vertices.size(); ++v){
+      switch_to_lpid_[vertices[v]] = rank;
+      switch_to_thread_[vertices[v]] = thread_part[v];
+    }
+  }
+
+  if (sprockit::Debug::slotActive(sprockit::dbg::partition)){
+    std::vector<int> worker(num_switches_total_);
+    for (int i=0; i < num_switches_total_; ++i){
+      worker[i] = switch_to_lpid_[i] * nthread_ + switch_to_thread_[i];
+    }
+    part_debug("graph partition cuts %ld link weight between ranks and %ld in total",
+               long(GraphPartitioner::edgeCut(graph_, rank_part)),
+               long(GraphPartitioner::edgeCut(graph_, worker)));
+  }
+}
+
 }
@@ -54,6 +54,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/hardware/interconnect/interconnect_fwd.h>
 
 #include <sstmac/sst_core/integrated_component.h>
+#include <sstmac/backends/common/graph_partition.h>
 
 #include <vector>
 
@@ -95,6 +96,16 @@ class Partition
     return switch_to_thread_[id];
   }
 
+  /**
+   * @brief setThreadForSwitch
+   * Used when the switch is migrated to another thread on the same rank
+   * @param id
+   * @param thread
+   */
+  void setThreadForSwitch(int id, int thread) {
+    switch_to_thread_[id] = thread;
+  }
+
   virtual void finalizeInit(SST::Params&){}
 
  protected:
@@ -188,6 +199,39 @@ class BlockPartition :
 
 };
 
+class GraphPartition :
+  public BlockPartition
+{
+ public:
+  SST_ELI_REGISTER_DERIVED(
+    Partition,
+    GraphPartition,
+    "macro",
+    "graph",
+    SST_ELI_ELEMENT_VERSION(1,0,0),
+    "partition from a multilevel k-way partition of the switch graph")
+
+  GraphPartition(SST::Params& params, ParallelRuntime* rt);
+
+  ~GraphPartition() override;
+
+  /**
+   * @brief partitionSwitches
+   * Switches are weighted by their attached nodes and links by bandwidth over latency,
+   * so that cuts fall on few, long links. The switch graph is first split across ranks
+   * and then each rank's piece is split across its threads.
+   */
+  void partitionSwitches() override;
+
+ protected:
+  void buildSwitchGraph(SST::Params& params);
+
+  double imbalance_;
+
+  GraphPartitioner::Graph graph_;
+
+};
+
 class OccupiedBlockPartition :
   public BlockPartition
 {
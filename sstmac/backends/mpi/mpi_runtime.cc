@@ -180,8 +180,9 @@ MpiRuntime::globalSum(uint64_t *data, int nelems, int root)
 void
 MpiRuntime::initRuntimeParams(SST::Params& params)
 {
-  requests_.resize(2*nproc_);
-  statuses_.resize(2*nproc_);
+  //null message epochs can have a header and a payload to send and a payload to receive per rank
+  requests_.resize(3*nproc_);
+  statuses_.resize(3*nproc_);
   votes_.resize(nproc_);
   ParallelRuntime::initRuntimeParams(params);
 }
@@ -189,7 +190,9 @@ MpiRuntime::initRuntimeParams(SST::Params& params)
 MpiRuntime::MpiRuntime(SST::Params& params) :
   ParallelRuntime(params,
   initRank(params),
-  initSize(params))
+  initSize(params)),
+  null_recvs_posted_(false),
+  vote_pending_(false)
 {
   epoch_ = 0;
   int rc = MPI_Op_create(&voteReduceFunction, 1, &vote_op_);
@@ -317,6 +320,98 @@ MpiRuntime::sendRecvMessages(Timestamp vote)
   return Timestamp(0, incoming.time_vote);
 }
 
+static const int null_message_tag = 44;
+static const int null_payload_tag = 45;
+
+void
+MpiRuntime::postNullRecvs(const std::vector<int>& recvRanks)
+{
+  null_recvs_.resize(recvRanks.size());
+  null_requests_.resize(recvRanks.size());
+  for (int i=0; i < recvRanks.size(); ++i){
+    MPI_Irecv(&null_recvs_[i], sizeof(null_message), MPI_BYTE, recvRanks[i],
+              null_message_tag, MPI_COMM_WORLD, &null_requests_[i]);
+  }
+  null_recvs_posted_ = true;
+}
+
+Timestamp
+MpiRuntime::sendRecvNullMessages(const std::vector<int>& sendRanks,
+                                 const std::vector<Timestamp>& promises,
+                                 const std::vector<int>& recvRanks,
+                                 Timestamp vote, Timestamp& global_vote)
+{
+  if (!null_recvs_posted_){
+    postNullRecvs(recvRanks);
+  }
+
+  int reqIdx = 0;
+  null_sends_.resize(sendRanks.size());
+  for (int i=0; i < sendRanks.size(); ++i){
+    int dst = sendRanks[i];
+    CommBuffer& comm = send_buffers_[dst];
+    int commSize = comm.totalBytes();
+    null_message& msg = null_sends_[i];
+    msg.epochs = promises[i].epochs;
+    msg.ticks = promises[i].time.ticks();
+    msg.num_bytes = commSize;
+    MPI_Isend(&msg, sizeof(null_message), MPI_BYTE, dst,
+              null_message_tag, MPI_COMM_WORLD, &requests_[reqIdx++]);
+    if (commSize){
+      char* buffer = comm.buffer();
+      if (comm.hasBackup()){
+        buffer = comm.backup();
+        comm.copyToBackup();
+      }
+      debug_printf(sprockit::dbg::parallel, "LP %d sending %d bytes to LP %d on epoch %d",
+                   me_, commSize, dst, epoch_);
+      MPI_Isend(buffer, commSize, MPI_BYTE, dst,
+                null_payload_tag, MPI_COMM_WORLD, &requests_[reqIdx++]);
+      sends_done_[num_sends_done_++] = dst;
+    }
+  }
+
+  MPI_Waitall(null_requests_.size(), null_requests_.data(), MPI_STATUSES_IGNORE);
+  null_recvs_posted_ = false;
+
+  Timestamp horizon = Timestamp::max();
+  for (int i=0; i < recvRanks.size(); ++i){
+    const null_message& msg = null_recvs_[i];
+    horizon = std::min(horizon, Timestamp(msg.epochs, msg.ticks));
+    if (msg.num_bytes){
+      CommBuffer& comm = recv_buffers_[numRecvsDone_];
+      comm.ensureSpace(msg.num_bytes);
+      debug_printf(sprockit::dbg::parallel, "LP %d receiving %lu bytes from LP %d on epoch %d",
+                   me_, msg.num_bytes, recvRanks[i], epoch_);
+      MPI_Irecv(comm.buffer(), msg.num_bytes, MPI_BYTE, recvRanks[i],
+                null_payload_tag, MPI_COMM_WORLD, &requests_[reqIdx++]);
+      //the size is known exactly, the headers can be reposted before the payload arrives
+      comm.shift(msg.num_bytes);
+      ++numRecvsDone_;
+    }
+  }
+
+  //the vote started last epoch completed in the background while events ran,
+  //all ranks see the same result on the same epoch and stop together
+  if (vote_pending_){
+    MPI_Wait(&vote_request_, MPI_STATUS_IGNORE);
+    vote_pending_ = false;
+    global_vote = Timestamp(0, vote_recv_);
+  }
+  if (global_vote != Timestamp::max()){
+    postNullRecvs(recvRanks);
+    vote_send_ = vote.time.ticks();
+    MPI_Iallreduce(&vote_send_, &vote_recv_, 1, MPI_UINT64_T, MPI_MIN,
+                   MPI_COMM_WORLD, &vote_request_);
+    vote_pending_ = true;
+  }
+
+  MPI_Waitall(reqIdx, requests_.data(), MPI_STATUSES_IGNORE);
+
+  ++epoch_;
+  return horizon;
+}
+
 void
 MpiRuntime::send(int dst, void *buffer, int buffer_size)
 {
@@ -99,6 +99,11 @@ class MpiRuntime :
 
   Timestamp sendRecvMessages(Timestamp vote) override;
 
+  Timestamp sendRecvNullMessages(const std::vector<int>& sendRanks,
+                                 const std::vector<Timestamp>& promises,
+                                 const std::vector<int>& recvRanks,
+                                 Timestamp vote, Timestamp& global_vote) override;
+
  protected:
   void doReduce(void* data, int nelems, MPI_Datatype ty, MPI_Op op, int root);
 
@@ -115,10 +120,34 @@ class MpiRuntime :
     uint64_t max_bytes;
   };
 
+  struct null_message {
+    uint64_t epochs;
+    uint64_t ticks;
+    uint64_t num_bytes;
+  };
+
+  /**
+   * @brief postNullRecvs
+   * Post the receives for the next epoch's null messages so they can complete while events run
+   * @param recvRanks
+   */
+  void postNullRecvs(const std::vector<int>& recvRanks);
+
   std::vector<MPI_Request> requests_;
   std::vector<MPI_Status> statuses_;
   std::vector<send_recv_vote> votes_;
 
+  std::vector<null_message> null_sends_;
+  std::vector<null_message> null_recvs_;
+  std::vector<MPI_Request> null_requests_;
+  bool null_recvs_posted_;
+
+  /** The termination vote started at the end of one epoch and completed at the end of the next */
+  MPI_Request vote_request_;
+  bool vote_pending_;
+  uint64_t vote_send_;
+  uint64_t vote_recv_;
+
   MPI_Datatype vote_type_;
   MPI_Op vote_op_;
 
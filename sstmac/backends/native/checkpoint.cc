@@ -0,0 +1,391 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+
+#include <sstmac/backends/native/checkpoint.h>
+#include <sstmac/common/event_manager.h>
+#include <sstmac/common/sst_event.h>
+#include <sprockit/errors.h>
+#include <sprockit/output.h>
+#include <sprockit/keyword_registration.h>
+#include <sprockit/sim_parameters.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <limits.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
+#include <iostream>
+
+RegisterKeywords(
+{ "checkpoint_time", "the simulated time at which to suspend a checkpoint copy of the simulation" },
+{ "checkpoint_file", "the unix socket path on which the checkpoint server accepts restarts" },
+{ "checkpoint_timeout", "how long the checkpoint server waits for a restart before exiting" },
+);
+
+namespace sstmac {
+namespace native {
+
+namespace {
+
+struct CheckpointRequest {
+  uint32_t cmd;
+  char cwd[PATH_MAX];
+};
+
+class CheckpointEvent : public ExecutionEvent
+{
+ public:
+  CheckpointEvent(Checkpoint* ckpt) : ckpt_(ckpt) {}
+
+  void execute() override {
+    if (ckpt_->take()){
+      cout0 << sprockit::sprintf("--- Resumed from checkpoint at t=%20.12fs -----\n",
+                                 ckpt_->time().sec());
+    }
+  }
+
+ private:
+  Checkpoint* ckpt_;
+};
+
+static sockaddr_un
+socketAddress(const std::string& path)
+{
+  sockaddr_un addr;
+  ::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)){
+    spkt_abort_printf("checkpoint file path %s is too long for a unix socket", path.c_str());
+  }
+  ::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+  return addr;
+}
+
+static bool
+writeAll(int fd, const void* buf, size_t size)
+{
+  const char* ptr = (const char*) buf;
+  while (size > 0){
+    ssize_t rc = ::write(fd, ptr, size);
+    if (rc < 0 && errno == EINTR) continue;
+    if (rc <= 0) return false;
+    ptr += rc;
+    size -= rc;
+  }
+  return true;
+}
+
+static bool
+readAll(int fd, void* buf, size_t size)
+{
+  char* ptr = (char*) buf;
+  while (size > 0){
+    ssize_t rc = ::read(fd, ptr, size);
+    if (rc < 0 && errno == EINTR) continue;
+    if (rc <= 0) return false;
+    ptr += rc;
+    size -= rc;
+  }
+  return true;
+}
+
+/**
+ * Receive a request together with the client's stdout/stderr.
+ * The request struct is small enough to always arrive in one message.
+ */
+static bool
+recvRequest(int conn, CheckpointRequest& req, int fds[2])
+{
+  iovec iov;
+  iov.iov_base = &req;
+  iov.iov_len = sizeof(req);
+  char ctrl[CMSG_SPACE(2*sizeof(int))];
+  msghdr msg;
+  ::memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = ctrl;
+  msg.msg_controllen = sizeof(ctrl);
+  ssize_t rc;
+  do {
+    rc = ::recvmsg(conn, &msg, MSG_WAITALL);
+  } while (rc < 0 && errno == EINTR);
+  if (rc != sizeof(req)) return false;
+
+  fds[0] = fds[1] = -1;
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  if (cmsg && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS
+      && cmsg->cmsg_len == CMSG_LEN(2*sizeof(int))){
+    ::memcpy(fds, CMSG_DATA(cmsg), 2*sizeof(int));
+  }
+  req.cwd[PATH_MAX-1] = '\0';
+  return true;
+}
+
+}
+
+Checkpoint::Checkpoint(SST::Params& params)
+{
+  time_ = Timestamp(params.find<SST::UnitAlgebra>("checkpoint_time").getValue().toDouble());
+  path_ = params.find<std::string>("checkpoint_file", "sstmac.ckpt");
+  timeout_ = params.find<SST::UnitAlgebra>("checkpoint_timeout", "3600s").getValue().toDouble();
+}
+
+bool
+Checkpoint::requested(SST::Params& params)
+{
+  return params.contains("checkpoint_time");
+}
+
+void
+Checkpoint::schedule(EventManager* mgr)
+{
+  if (mgr->nproc() > 1 || mgr->nthread() > 1){
+    spkt_abort_printf("checkpoint_time is only supported for serial runs, "
+                      "have %d ranks and %d threads", mgr->nproc(), mgr->nthread());
+  }
+  auto* ev = new CheckpointEvent(this);
+  ev->setTime(time_);
+  ev->setSeqnum(0);
+  mgr->schedule(ev);
+}
+
+bool
+Checkpoint::take()
+{
+  int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0){
+    spkt_abort_printf("checkpoint: failed to create socket: %s", ::strerror(errno));
+  }
+  sockaddr_un addr = socketAddress(path_);
+  //replace any stale socket left from a previous run
+  ::unlink(path_.c_str());
+  if (::bind(fd, (sockaddr*) &addr, sizeof(addr)) != 0 || ::listen(fd, 16) != 0){
+    spkt_abort_printf("checkpoint: failed to listen on %s: %s",
+                      path_.c_str(), ::strerror(errno));
+  }
+
+  //nothing buffered may be duplicated into the copies
+  std::cout.flush();
+  std::cerr.flush();
+  ::fflush(stdout);
+  ::fflush(stderr);
+
+  pid_t child = ::fork();
+  if (child < 0){
+    spkt_abort_printf("checkpoint: fork failed: %s", ::strerror(errno));
+  } else if (child > 0){
+    //the original run continues - reap the intermediate process
+    ::close(fd);
+    int status;
+    while (::waitpid(child, &status, 0) < 0 && errno == EINTR);
+    cout0 << sprockit::sprintf("--- Checkpoint at t=%20.12fs served from %s -----\n",
+                               time_.sec(), path_.c_str());
+    return false;
+  }
+
+  //detach from the terminal session and the original run
+  ::setsid();
+  pid_t server = ::fork();
+  if (server != 0){
+    ::_exit(server < 0 ? 1 : 0);
+  }
+
+  serve(fd);
+  return true;
+}
+
+void
+Checkpoint::serve(int listen_fd)
+{
+  int devnull = ::open("/dev/null", O_RDWR);
+  ::dup2(devnull, STDIN_FILENO);
+  ::dup2(devnull, STDOUT_FILENO);
+  ::dup2(devnull, STDERR_FILENO);
+  ::close(devnull);
+
+  int timeout_ms = timeout_ > 0 ? int(timeout_ * 1000) : -1;
+  while (true){
+    pollfd pfd;
+    pfd.fd = listen_fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    int rc = ::poll(&pfd, 1, timeout_ms);
+    if (rc < 0 && errno == EINTR) continue;
+    if (rc <= 0) break; //idle timeout or error
+
+    int conn = ::accept(listen_fd, nullptr, nullptr);
+    if (conn < 0) continue;
+
+    CheckpointRequest req;
+    int fds[2];
+    if (!recvRequest(conn, req, fds)){
+      ::close(conn);
+      continue;
+    }
+
+    if (req.cmd == Shutdown){
+      int status = 0;
+      writeAll(conn, &status, sizeof(status));
+      ::close(conn);
+      break;
+    }
+
+    pid_t pid = ::fork();
+    if (pid == 0){
+      //this copy resumes the simulation on behalf of the client
+      ::close(listen_fd);
+      ::close(conn);
+      if (fds[0] >= 0) ::dup2(fds[0], STDOUT_FILENO);
+      if (fds[1] >= 0) ::dup2(fds[1], STDERR_FILENO);
+      if (fds[0] >= 0) ::close(fds[0]);
+      if (fds[1] >= 0) ::close(fds[1]);
+      if (::chdir(req.cwd) != 0){
+        std::cerr << "checkpoint: could not change to " << req.cwd
+                  << ", writing output to " << ::getcwd(req.cwd, PATH_MAX) << std::endl;
+      }
+      return;
+    }
+
+    if (fds[0] >= 0) ::close(fds[0]);
+    if (fds[1] >= 0) ::close(fds[1]);
+    int status = 1;
+    if (pid > 0){
+      while (::waitpid(pid, &status, 0) < 0 && errno == EINTR);
+    }
+    writeAll(conn, &status, sizeof(status));
+    ::close(conn);
+  }
+
+  ::close(listen_fd);
+  ::unlink(path_.c_str());
+  ::_exit(0);
+}
+
+int
+Checkpoint::request(const std::string& path, Command cmd)
+{
+  int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un addr = socketAddress(path);
+  if (fd < 0 || ::connect(fd, (sockaddr*) &addr, sizeof(addr)) != 0){
+    spkt_abort_printf("could not connect to checkpoint server at %s: %s",
+                      path.c_str(), ::strerror(errno));
+  }
+
+  CheckpointRequest req;
+  ::memset(&req, 0, sizeof(req));
+  req.cmd = cmd;
+  if (!::getcwd(req.cwd, sizeof(req.cwd))){
+    spkt_abort_printf("checkpoint restart: could not get working directory: %s",
+                      ::strerror(errno));
+  }
+
+  std::cout.flush();
+  std::cerr.flush();
+  ::fflush(stdout);
+  ::fflush(stderr);
+
+  int fds[2] = { STDOUT_FILENO, STDERR_FILENO };
+  iovec iov;
+  iov.iov_base = &req;
+  iov.iov_len = sizeof(req);
+  char ctrl[CMSG_SPACE(sizeof(fds))];
+  ::memset(ctrl, 0, sizeof(ctrl));
+  msghdr msg;
+  ::memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = ctrl;
+  msg.msg_controllen = sizeof(ctrl);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+  ::memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+  ssize_t rc;
+  do {
+    rc = ::sendmsg(fd, &msg, 0);
+  } while (rc < 0 && errno == EINTR);
+  if (rc != sizeof(req)){
+    spkt_abort_printf("failed sending request to checkpoint server at %s", path.c_str());
+  }
+
+  int status;
+  if (!readAll(fd, &status, sizeof(status))){
+    spkt_abort_printf("checkpoint server at %s exited before the restart completed",
+                      path.c_str());
+  }
+  ::close(fd);
+
+  if (WIFEXITED(status)){
+    return WEXITSTATUS(status);
+  } else if (WIFSIGNALED(status)){
+    std::cerr << "resumed simulation terminated by signal " << WTERMSIG(status) << std::endl;
+    return 128 + WTERMSIG(status);
+  } else {
+    return 1;
+  }
+}
+
+int
+Checkpoint::restart(const std::string& path)
+{
+  return request(path, Resume);
+}
+
+int
+Checkpoint::shutdown(const std::string& path)
+{
+  return request(path, Shutdown);
+}
+
+}
+}
@@ -0,0 +1,140 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+
+#ifndef SSTMAC_BACKENDS_NATIVE_CHECKPOINT_H_INCLUDED
+#define SSTMAC_BACKENDS_NATIVE_CHECKPOINT_H_INCLUDED
+
+#include <sstmac/common/sstmac_config.h>
+#if !SSTMAC_INTEGRATED_SST_CORE
+
+#include <sstmac/common/timestamp.h>
+#include <sstmac/common/event_manager_fwd.h>
+#include <sprockit/sim_parameters_fwd.h>
+#include <sstmac/sst_core/integrated_component.h>
+#include <string>
+
+namespace sstmac {
+namespace native {
+
+/**
+ * @brief Checkpoint/restart of a serial simulation at a fixed simulated time.
+ *
+ * Rather than serializing every component, thread stack and library object,
+ * the simulation is suspended in place. When the checkpoint event fires,
+ * the process forks a detached server that owns a frozen copy of the entire
+ * address space - event queue, components, MPI/sumi state and every
+ * StackAlloc thread stack. The original run continues as before.
+ * The server listens on a unix-domain socket at checkpoint_file. Every
+ * `sstmac --restart <checkpoint_file>` forks a fresh copy of the frozen
+ * process, hands it the client's working directory, stdout and stderr,
+ * and the copy resumes the simulation from the checkpoint time.
+ * Output files are therefore written relative to the restarting
+ * client's directory.
+ */
+class Checkpoint
+{
+ public:
+  /**
+   * @param params  Top-level parameters, reads checkpoint_time,
+   *                checkpoint_file and checkpoint_timeout
+   */
+  Checkpoint(SST::Params& params);
+
+  /**
+   * @brief Whether a checkpoint time was requested
+   */
+  static bool requested(SST::Params& params);
+
+  /**
+   * @brief Schedule the event that suspends the simulation
+   * @param mgr The (only) event manager of a serial run
+   */
+  void schedule(EventManager* mgr);
+
+  /**
+   * @brief Fork the checkpoint server.
+   * @return False in the original run, true in a restarted copy.
+   *         Never returns in the server process.
+   */
+  bool take();
+
+  Timestamp time() const {
+    return time_;
+  }
+
+  /**
+   * @brief Resume a simulation from a running checkpoint server
+   * @param path  The socket path given as checkpoint_file
+   * @return The exit code of the resumed simulation
+   */
+  static int restart(const std::string& path);
+
+  /**
+   * @brief Tell a checkpoint server to exit
+   * @param path  The socket path given as checkpoint_file
+   */
+  static int shutdown(const std::string& path);
+
+ private:
+  enum Command : uint32_t {
+    Resume=0,
+    Shutdown=1
+  };
+
+  static int request(const std::string& path, Command cmd);
+
+  void serve(int listen_fd);
+
+  Timestamp time_;
+  std::string path_;
+  /** Seconds without a restart before the server exits, <= 0 is forever */
+  double timeout_;
+};
+
+}
+}
+
+#endif
+#endif
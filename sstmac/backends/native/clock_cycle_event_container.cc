@@ -52,10 +52,13 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/hardware/node/node.h>
 #include <sstmac/hardware/nic/nic.h>
 #include <sstmac/hardware/interconnect/interconnect.h>
+#include <sstmac/common/stats/stat_collector.h>
+#include <sstmac/common/ipc_event.h>
 #include <sprockit/util.h>
 #include <sprockit/keyword_registration.h>
 #include <limits>
 #include <cinttypes>
+#include <cstring>
 
 #define event_debug(...) \
   debug_printf(sprockit::dbg::parallel, "manager %d:%d %s", \
@@ -65,7 +68,11 @@ RegisterDebugSlot(EventManager_time_vote);
 
 RegisterKeywords(
   { "num_profile_loops", "the number of loops to execute of the parallel core for profiling parallel overheads" },
-  { "epoch_print_interval", "the print interval for stats on parallel execution" }
+  { "epoch_print_interval", "the print interval for stats on parallel execution" },
+  { "event_cycles", "statistic for the cycles each thread spends running events" },
+  { "barrier_cycles", "statistic for the cycles each thread spends synchronizing between epochs" },
+  { "epochs", "statistic for the number of epochs each thread runs" },
+  { "parallel_sync", "how ranks synchronize each epoch: allreduce (default) or null_message" }
 );
 
 #define epoch_debug(...) \
@@ -77,9 +84,6 @@ DeclareDebugSlot(thread_events)
 RegisterDebugSlot(thread_events)
 #endif
 
-static int epoch_print_interval = 10000;
-static uint64_t event_cycles = 0;
-static uint64_t barrier_cycles = 0;
 
 namespace sstmac {
 namespace native {
@@ -89,25 +93,74 @@ ClockCycleEventMap::ClockCycleEventMap(
   EventManager(params, rt)
 {
   num_profile_loops_ = params.find<int>("num_profile_loops", 0);
-  epoch_print_interval = params.find<int>("epoch_print_interval", epoch_print_interval);
+  epoch_print_interval_ = params.find<int>("epoch_print_interval", 10000);
+  auto sync = params.find<std::string>("parallel_sync", "allreduce");
+  if (sync == "null_message"){
+    if (rt->nthread() > 1){
+      spkt_abort_printf("parallel_sync=null_message is not supported with multiple threads per rank");
+    }
+    null_messages_ = true;
+  } else if (sync == "allreduce"){
+    null_messages_ = false;
+  } else {
+    spkt_abort_printf("invalid parallel_sync=%s: must be allreduce or null_message", sync.c_str());
+  }
+  if (rt->nthread() == 1){
+    //a multithreaded container registers stats for each of its threads
+    registerEpochStats(params, 0, epoch_stats_);
+  }
+}
+
+static Statistic<uint64_t>*
+makeEpochStatistic(SST::Params& params, const std::string& name, const std::string& subId)
+{
+  auto type = params.find<std::string>("type", "null");
+  auto* lib = Statistic<uint64_t>::getBuilderLibrary("macro");
+  auto* builder = lib ? lib->getBuilder(type) : nullptr;
+  if (!builder){
+    spkt_abort_printf("Bad stat type '%s' given for statistic '%s'",
+                      type.c_str(), name.c_str());
+  }
+  return builder->create(nullptr, name, subId, params);
+}
+
+void
+ClockCycleEventMap::registerEpochStats(SST::Params& params, int thread, EpochStats& stats)
+{
+  std::string subId = sprockit::sprintf("rank%d.thread%d", me_, thread);
+  Statistic<uint64_t>** stat_ptrs[] = { &stats.event_cycles, &stats.barrier_cycles, &stats.epochs };
+  const char* names[] = { "event_cycles", "barrier_cycles", "epochs" };
+  for (int i=0; i < 3; ++i){
+    auto scoped_params = params.find_scoped_params(names[i]);
+    Statistic<uint64_t>* stat = makeEpochStatistic(scoped_params, names[i], subId);
+    registerStatisticCore(stat, scoped_params);
+    *stat_ptrs[i] = stat;
+  }
+}
+
+void
+EpochStats::addEpoch(uint64_t event, uint64_t barrier)
+{
+  total_event_cycles += event;
+  total_barrier_cycles += barrier;
+  event_cycles->addData(event);
+  barrier_cycles->addData(barrier);
+  epochs->addData(1);
 }
 
 int
 ClockCycleEventMap::handleIncoming(char* buf)
 {
 #if SSTMAC_USE_MULTITHREAD
-  serializer ser;
-  ser.start_unpacking(buf, 1<<31); //just pass in a huge number
-  uint32_t sz; //these are guaranteed to be first
-  uint32_t thread;
-  ser & sz;
-  ser & thread;
-  if (sz == 0){
+  //the size and thread are at the front of the header
+  IpcEventBase hdr;
+  ::memcpy(&hdr, buf, sizeof(IpcEventBase));
+  if (hdr.ser_size == 0){
     sprockit::abort("got zero size for incoming buffer");
   }
-  EventManager* mgr = threadManager(thread);
+  EventManager* mgr = threadManager(hdr.thread);
   mgr->schedulePendingSerialization(buf);
-  return sz;
+  return hdr.ser_size;
 #else
   return serializeSchedule(buf);
 #endif
@@ -128,6 +181,13 @@ ClockCycleEventMap::receiveIncomingEvents(Timestamp vote)
 
   event_debug("got back minimum time %10.6e", min_time.sec());
 
+  handleRecvBuffers();
+  return min_time;
+}
+
+void
+ClockCycleEventMap::handleRecvBuffers()
+{
   int num_recvs = rt_->numRecvsDone();
   for (int i=0; i < num_recvs; ++i){
     auto& buf = rt_->recvBuffer(i);
@@ -140,14 +200,114 @@ ClockCycleEventMap::receiveIncomingEvents(Timestamp vote)
     }
   }
   rt_->resetSendRecv();
-  return min_time;
 }
 
 
+void
+ClockCycleEventMap::computeRemoteLookahead()
+{
+  remote_lookahead_ = lookahead_;
+  send_ranks_.clear();
+  send_latencies_.clear();
+  recv_ranks_.clear();
+  if (nproc_ == 1) return;
+
+  std::vector<int64_t> my_latencies(nproc_, 0);
+  for (int t=0; t < nthread(); ++t){
+    EventManager* mgr = threadManager(t);
+    for (int r=0; r < nproc_; ++r){
+      int64_t lat = mgr->minRankLinkLatency(r).ticks();
+      if (lat != 0 && (my_latencies[r] == 0 || lat < my_latencies[r])){
+        my_latencies[r] = lat;
+      }
+    }
+  }
+
+  for (int r=0; r < nproc_; ++r){
+    if (my_latencies[r] != 0){
+      send_ranks_.push_back(r);
+      send_latencies_.emplace_back(my_latencies[r], TimeDelta::exact);
+    }
+  }
+
+  //row i holds the latencies out of rank i, so column me holds the latencies into this rank
+  std::vector<int64_t> all_latencies(nproc_*nproc_);
+  rt_->allgather(my_latencies.data(), nproc_*sizeof(int64_t), all_latencies.data());
+  int64_t min_incoming = 0;
+  for (int r=0; r < nproc_; ++r){
+    int64_t lat = all_latencies[r*nproc_ + me_];
+    if (lat != 0){
+      recv_ranks_.push_back(r);
+      if (min_incoming == 0 || lat < min_incoming){
+        min_incoming = lat;
+      }
+    }
+  }
+
+  if (min_incoming != 0){
+    remote_lookahead_ = TimeDelta(min_incoming, TimeDelta::exact);
+  }
+  event_debug("rank %d has remote lookahead %10.6e", me_, remote_lookahead_.sec());
+}
+
+void
+ClockCycleEventMap::runNullMessages()
+{
+  if (rt_->me() == 0){
+    printf("Running parallel simulation with null messages and lookahead %10.6fus\n",
+           remote_lookahead_.usec());
+  }
+
+  //nothing can arrive from another rank before the first link latency
+  Timestamp horizon = recv_ranks_.empty() ? no_events_left_time : Timestamp() + remote_lookahead_;
+  //the result of the last completed global vote, a lower bound on all future events
+  Timestamp global_bound;
+  std::vector<Timestamp> promises(send_ranks_.size());
+  uint64_t epoch = 0;
+  while (global_bound != no_events_left_time){
+    event_debug("running to null message horizon %10.6e", horizon.sec());
+    auto t_start = rdtsc();
+    Timestamp min_time = stopped_ ? no_events_left_time : runEvents(horizon);
+    auto t_run = rdtsc();
+    //events received later are no earlier than the horizon, so nothing
+    //I send in the future can be earlier than the bound plus the link latency
+    Timestamp bound = std::max(std::min(min_time, horizon), global_bound);
+    for (int i=0; i < send_ranks_.size(); ++i){
+      promises[i] = bound == no_events_left_time ? bound : bound + send_latencies_[i];
+    }
+    horizon = rt_->sendRecvNullMessages(send_ranks_, promises, recv_ranks_, min_time, global_bound);
+    if (global_bound != no_events_left_time && !recv_ranks_.empty()){
+      //the global vote lets idle ranks skip ahead without exchanging many null messages
+      horizon = std::max(horizon, global_bound + remote_lookahead_);
+    }
+    handleRecvBuffers();
+    if (stopped_){
+      clearEvents();
+    }
+    auto t_stop = rdtsc();
+    epoch_stats_.addEpoch(t_run - t_start, t_stop - t_run);
+    if (epoch % epoch_print_interval_ == 0 && rt_->me() == 0){
+      printf("Epoch %13" PRIu64 " ran %13" PRIu64 ", %13" PRIu64 " cumulative %13" PRIu64
+             ", %13" PRIu64 " until horizon %13" PRIu64 "\n",
+             epoch, t_run - t_start, t_stop - t_run, epoch_stats_.total_event_cycles,
+             epoch_stats_.total_barrier_cycles, horizon.time.ticks());
+    }
+    ++epoch;
+  }
+  computeFinalTime(now_);
+  if (rt_->me() == 0) printf("Ran %" PRIu64 " epochs on MPI parallel\n", epoch);
+  finalizeStatsOutput();
+}
+
 void
 ClockCycleEventMap::run()
 {
   interconn_->setup();
+  computeRemoteLookahead();
+  if (null_messages_ && nproc_ > 1){
+    runNullMessages();
+    return;
+  }
 
   Timestamp lower_bound;
   /** If we want to just execute the synchronization without any actual events
@@ -168,9 +328,9 @@ ClockCycleEventMap::run()
   uint64_t epoch = 0;
 
   while (lower_bound != no_events_left_time || num_loops_left > 0){
-    Timestamp horizon = lower_bound + lookahead_;
+    Timestamp horizon = lower_bound + remote_lookahead_;
     event_debug("running from %10.6e->%10.6e for lookahead %10.6e",
-                lower_bound.sec(), horizon.sec(), lookahead_.sec());
+                lower_bound.sec(), horizon.sec(), remote_lookahead_.sec());
     auto t_start = rdtsc();
     Timestamp min_time = runEvents(horizon);
     auto t_run = rdtsc();
@@ -178,12 +338,12 @@ ClockCycleEventMap::run()
     auto t_stop = rdtsc();
     uint64_t event = t_run - t_start;
     uint64_t barrier = t_stop - t_run;
-    event_cycles += event;
-    barrier_cycles += barrier;
-    if (epoch % epoch_print_interval == 0 && rt_->me() == 0){
+    epoch_stats_.addEpoch(event, barrier);
+    if (epoch % epoch_print_interval_ == 0 && rt_->me() == 0){
       printf("Epoch %13" PRIu64 " ran %13" PRIu64 ", %13" PRIu64 " cumulative %13" PRIu64
              ", %13" PRIu64 " until horizon %13" PRIu64 "\n",
-             epoch, event, barrier, event_cycles, barrier_cycles, horizon.time.ticks());
+             epoch, event, barrier, epoch_stats_.total_event_cycles,
+             epoch_stats_.total_barrier_cycles, horizon.time.ticks());
     }
     if (num_loops_left > 0){
       --num_loops_left;
@@ -192,6 +352,7 @@ ClockCycleEventMap::run()
   }
   computeFinalTime(now_);
   if (rt_->me() == 0) printf("Ran %" PRIu64 " epochs on MPI parallel\n", epoch);
+  finalizeStatsOutput();
 }
 
 void
@@ -51,6 +51,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/common/event_manager.h>
 #include <sstmac/hardware/interconnect/interconnect_fwd.h>
 #include <sstmac/backends/common/parallel_runtime.h>
+#include <sstmac/common/stats/stat_collector_fwd.h>
 
 DeclareDebugSlot(EventManager_time_vote);
 
@@ -62,12 +63,25 @@ enum class vote_type_t {
   min
 };
 
-static inline uint64_t rdtsc(void)
-{
-  uint32_t hi, lo;
-  __asm__ __volatile__ ("rdtsc" : "=a"(lo), "=d"(hi));
-  return uint64_t( (uint64_t)lo | (uint64_t)hi<<32);
-}
+/**
+ * @brief The EpochStats struct
+ * Statistics for one thread on the cycles spent running events
+ * and synchronizing with the other threads and ranks each epoch
+ */
+struct EpochStats {
+  EpochStats() :
+    event_cycles(nullptr), barrier_cycles(nullptr), epochs(nullptr),
+    total_event_cycles(0), total_barrier_cycles(0)
+  {}
+
+  void addEpoch(uint64_t event, uint64_t barrier);
+
+  Statistic<uint64_t>* event_cycles;
+  Statistic<uint64_t>* barrier_cycles;
+  Statistic<uint64_t>* epochs;
+  uint64_t total_event_cycles;
+  uint64_t total_barrier_cycles;
+};
 
 class ClockCycleEventMap :
   public EventManager
@@ -95,11 +109,60 @@ class ClockCycleEventMap :
 
   void computeFinalTime(Timestamp vote);
 
+  /**
+   * @brief registerEpochStats
+   * Create the event_cycles, barrier_cycles, and epochs statistics for a thread
+   * @param params
+   * @param thread
+   * @param stats [out]
+   */
+  void registerEpochStats(SST::Params& params, int thread, EpochStats& stats);
+
+  /**
+   * @brief computeRemoteLookahead
+   * Exchange the minimum link latency between every pair of ranks and
+   * set the remote lookahead to the minimum over the links into this rank.
+   * Must be called after the interconnect has been built.
+   */
+  void computeRemoteLookahead();
+
   int num_profile_loops_;
 
+  /** The minimum latency of any link from another rank into this rank */
+  TimeDelta remote_lookahead_;
+
+  /** The ranks this rank has links to */
+  std::vector<int> send_ranks_;
+
+  /** The minimum latency of the links to each rank in send_ranks_ */
+  std::vector<TimeDelta> send_latencies_;
+
+  /** The ranks with links into this rank */
+  std::vector<int> recv_ranks_;
+
+  /** Whether to synchronize ranks with null messages instead of a global vote every epoch */
+  bool null_messages_;
+
+  int epoch_print_interval_;
+
+  EpochStats epoch_stats_;
+
  private:
   void run() override;
 
+  /**
+   * @brief runNullMessages
+   * Run with each rank exchanging events and null messages only with its neighbors,
+   * detecting termination with a global vote that overlaps the next epoch
+   */
+  void runNullMessages();
+
+  /**
+   * @brief handleRecvBuffers
+   * Schedule the events in all buffers received from other ranks this epoch
+   */
+  void handleRecvBuffers();
+
   int handleIncoming(char* buf);
 
 
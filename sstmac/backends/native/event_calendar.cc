@@ -0,0 +1,272 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#include <sstmac/common/sstmac_config.h>
+#if !SSTMAC_INTEGRATED_SST_CORE
+#define __STDC_FORMAT_MACROS
+#include <sstmac/backends/native/event_calendar.h>
+#include <sprockit/keyword_registration.h>
+#include <sprockit/sim_parameters.h>
+#include <algorithm>
+#include <limits>
+#include <cinttypes>
+
+RegisterKeywords(
+{ "calendar_min_buckets", "the minimum (and initial) number of buckets in the event calendar" },
+{ "calendar_bucket_width", "the initial width in simulated time of each bucket in the event calendar" },
+);
+
+namespace sstmac {
+namespace native {
+
+static const int num_width_samples = 25;
+
+static inline uint64_t saturatingAdd(uint64_t a, uint64_t b){
+  uint64_t max = std::numeric_limits<uint64_t>::max();
+  return a > (max - b) ? max : a + b;
+}
+
+EventCalendar::EventCalendar(SST::Params& params, ParallelRuntime* rt) :
+  EventManager(params, rt),
+  size_(0),
+  cur_bucket_(0)
+{
+  if (nproc_ > 1 || nthread_ > 1){
+    spkt_abort_printf("calendar event manager only supports serial runs, got %d procs and %d threads",
+                      nproc_, int(nthread_));
+  }
+
+  uint64_t nbuckets = params.find<int>("calendar_min_buckets", 64);
+  min_buckets_ = 1;
+  while (min_buckets_ < nbuckets){
+    min_buckets_ *= 2;
+  }
+
+  TimeDelta width(params.find<SST::UnitAlgebra>("calendar_bucket_width", "1ns").getValue().toDouble());
+  width_ = std::max(uint64_t(1), width.ticks());
+  cur_top_ = width_;
+
+  resize(min_buckets_);
+}
+
+void
+EventCalendar::setPosition(uint64_t ticks)
+{
+  cur_bucket_ = bucketIndex(ticks);
+  cur_top_ = saturatingAdd(ticks - ticks % width_, width_);
+}
+
+uint64_t
+EventCalendar::sampleWidth(std::vector<ExecutionEvent*>& events)
+{
+  if (events.size() < 2) return width_;
+
+  size_t nsamples = std::min(events.size(), size_t(num_width_samples));
+  std::nth_element(events.begin(), events.begin() + nsamples - 1, events.end(), EventCompare());
+  std::sort(events.begin(), events.begin() + nsamples, EventCompare());
+
+  uint64_t total_sep = events[nsamples-1]->time().time.ticks() - events[0]->time().time.ticks();
+  if (total_sep == 0){
+    //all the earliest events are at the same time, no information
+    return width_;
+  }
+
+  //throw out separations much larger than the average
+  //so that a few outliers do not dominate the width
+  uint64_t avg_sep = total_sep / (nsamples - 1);
+  uint64_t cutoff = 2*avg_sep;
+  uint64_t small_sep = 0;
+  uint64_t num_small = 0;
+  for (size_t i=1; i < nsamples; ++i){
+    uint64_t sep = events[i]->time().time.ticks() - events[i-1]->time().time.ticks();
+    if (sep <= cutoff){
+      small_sep += sep;
+      ++num_small;
+    }
+  }
+
+  uint64_t new_width = num_small ? 3*small_sep/num_small : 3*avg_sep;
+  return std::max(uint64_t(1), new_width);
+}
+
+void
+EventCalendar::resize(uint64_t nbuckets)
+{
+  std::vector<ExecutionEvent*> events;
+  events.reserve(size_);
+  for (Bucket& b : buckets_){
+    events.insert(events.end(), b.events.begin() + b.head, b.events.end());
+  }
+
+  width_ = sampleWidth(events);
+
+  buckets_.clear();
+  buckets_.resize(nbuckets);
+  mask_ = nbuckets - 1;
+  grow_threshold_ = 2*nbuckets;
+  shrink_threshold_ = nbuckets > min_buckets_ ? nbuckets / 2 : 0;
+
+  //sampling has moved the earliest event to the front
+  setPosition(events.empty() ? now_.time.ticks() : events[0]->time().time.ticks());
+
+  for (ExecutionEvent* ev : events){
+    insert(ev);
+  }
+}
+
+void
+EventCalendar::insert(ExecutionEvent* ev)
+{
+  Bucket& b = buckets_[bucketIndex(ev->time().time.ticks())];
+  //the common case is an event later than everything else in the bucket
+  if (b.empty() || !EventCompare()(ev, b.events.back())){
+    b.events.push_back(ev);
+  } else {
+    auto pos = std::upper_bound(b.events.begin() + b.head, b.events.end(), ev, EventCompare());
+    b.events.insert(pos, ev);
+  }
+}
+
+EventCalendar::Bucket*
+EventCalendar::findNext()
+{
+  if (size_ == 0) return nullptr;
+
+  //scan at most one year of buckets for an event in the current year
+  for (uint64_t i=0; i < buckets_.size(); ++i){
+    Bucket& b = buckets_[cur_bucket_];
+    if (!b.empty() && b.front()->time().time.ticks() < cur_top_){
+      return &b;
+    }
+    cur_bucket_ = (cur_bucket_ + 1) & mask_;
+    cur_top_ = saturatingAdd(cur_top_, width_);
+  }
+
+  //the events are sparse relative to the bucket width
+  //do a direct search for the minimum and jump ahead to its year
+  Bucket* next = nullptr;
+  for (Bucket& b : buckets_){
+    if (!b.empty() && (!next || EventCompare()(b.front(), next->front()))){
+      next = &b;
+    }
+  }
+  setPosition(next->front()->time().time.ticks());
+  return next;
+}
+
+void
+EventCalendar::schedule(ExecutionEvent* ev)
+{
+#if SSTMAC_SANITY_CHECK
+  if (ev->time() < now_){
+    spkt_abort_printf("Time went backwards on manager %d:%d to t=%10.6e for link=%" PRIu32 " seq=%" PRIu32,
+                      me_, thread_id_, ev->time().sec(), ev->linkId(), ev->seqnum());
+  }
+#endif
+  uint64_t ticks = ev->time().time.ticks();
+  if (ticks < cur_top_ - width_){
+    //event is earlier than the current bucket, move back to it
+    setPosition(ticks);
+  }
+  insert(ev);
+  ++size_;
+  if (size_ > grow_threshold_){
+    resize(2*buckets_.size());
+  }
+}
+
+Timestamp
+EventCalendar::minEventTime() const
+{
+  //finding the next event only advances the current position
+  //which does not change the logical state of the queue
+  Bucket* b = const_cast<EventCalendar*>(this)->findNext();
+  return b ? b->front()->time() : no_events_left_time;
+}
+
+Timestamp
+EventCalendar::runEvents(Timestamp event_horizon)
+{
+  registerPending();
+  min_ipc_time_ = no_events_left_time;
+  while (Bucket* b = findNext()){
+    ExecutionEvent* ev = b->front();
+#if SSTMAC_SANITY_CHECK
+    if (ev->time() < now_){
+      spkt_abort_printf("Time went backwards on manager %d:%d to t=%10.6e for link=%" PRIu32 " for seqnum=%" PRIu32,
+                        me_, thread_id_, ev->time().sec(), ev->linkId(), ev->seqnum());
+    }
+#endif
+    if (ev->time() >= event_horizon){
+      return std::min(min_ipc_time_, ev->time());
+    }
+    now_ = ev->time();
+    b->popFront();
+    --size_;
+    if (size_ < shrink_threshold_){
+      resize(buckets_.size() / 2);
+    }
+    ev->execute();
+    delete ev;
+  }
+  return min_ipc_time_;
+}
+
+void
+EventCalendar::clearEvents()
+{
+  for (Bucket& b : buckets_){
+    for (size_t i=b.head; i < b.events.size(); ++i){
+      delete b.events[i];
+    }
+    b.events.clear();
+    b.head = 0;
+  }
+  size_ = 0;
+}
+
+}
+}
+
+#endif // !SSTMAC_INTEGRATED_SST_CORE
@@ -0,0 +1,171 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#ifndef SSTMAC_BACKENDS_NATIVE_EVENT_CALENDAR_H_INCLUDED
+#define SSTMAC_BACKENDS_NATIVE_EVENT_CALENDAR_H_INCLUDED
+
+#include <sstmac/common/sstmac_config.h>
+#if !SSTMAC_INTEGRATED_SST_CORE
+
+#include <sstmac/common/event_manager.h>
+#include <vector>
+
+namespace sstmac {
+namespace native {
+
+/**
+ * @brief The EventCalendar class
+ * Implements a calendar queue (R. Brown, CACM 1988) for O(1) amortized scheduling.
+ * Events are hashed by time into a ring of buckets, each covering a fixed
+ * width of simulated time. Buckets are kept sorted with the same
+ * (time, linkId, seqnum) ordering as the default map event manager
+ * so that runs are bit-identical regardless of which queue is chosen.
+ * The number of buckets and the bucket width are resized as the
+ * number of pending events grows or shrinks.
+ */
+class EventCalendar :
+  public EventManager
+{
+ public:
+  SST_ELI_REGISTER_DERIVED(
+    EventManager,
+    EventCalendar,
+    "macro",
+    "calendar",
+    SST_ELI_ELEMENT_VERSION(1,0,0),
+    "Implements a serial event manager with a calendar queue for O(1) event scheduling")
+
+  EventCalendar(SST::Params& params, ParallelRuntime* rt);
+
+  void schedule(ExecutionEvent* ev) override;
+
+  Timestamp runEvents(Timestamp event_horizon) override;
+
+  Timestamp minEventTime() const override;
+
+ protected:
+  void clearEvents() override;
+
+ private:
+  struct Bucket {
+    Bucket() : head(0) {}
+
+    bool empty() const {
+      return head == events.size();
+    }
+
+    ExecutionEvent* front() const {
+      return events[head];
+    }
+
+    void popFront(){
+      ++head;
+      if (head == events.size()){
+        events.clear();
+        head = 0;
+      }
+    }
+
+    /** Events ordered by EventCompare, valid entries begin at head */
+    std::vector<ExecutionEvent*> events;
+    size_t head;
+  };
+
+  uint64_t bucketIndex(uint64_t ticks) const {
+    return (ticks / width_) & mask_;
+  }
+
+  /**
+   * @brief findNext
+   * Move the current position to the bucket holding the next event
+   * @return The bucket containing the minimum event, nullptr if empty
+   */
+  Bucket* findNext();
+
+  /**
+   * @brief setPosition
+   * Reset the current bucket/year to the bucket containing a given time
+   * @param ticks
+   */
+  void setPosition(uint64_t ticks);
+
+  void insert(ExecutionEvent* ev);
+
+  void resize(uint64_t nbuckets);
+
+  /**
+   * @brief sampleWidth
+   * Estimate a new bucket width from the separation of the earliest events
+   * @param events  All events in the calendar, the earliest are sorted to the front
+   * @return The new bucket width in ticks
+   */
+  uint64_t sampleWidth(std::vector<ExecutionEvent*>& events);
+
+  std::vector<Bucket> buckets_;
+
+  uint64_t mask_;
+
+  uint64_t width_;
+
+  uint64_t size_;
+
+  uint64_t cur_bucket_;
+
+  /** The (exclusive) upper time bound of the current bucket in the current year */
+  uint64_t cur_top_;
+
+  uint64_t min_buckets_;
+
+  /** The calendar is resized when the number of events leaves these bounds */
+  uint64_t grow_threshold_;
+  uint64_t shrink_threshold_;
+
+};
+
+}
+}
+
+#endif // !SSTMAC_INTEGRATED_SST_CORE
+
+#endif
@@ -0,0 +1,197 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+
+#include <sstmac/common/sstmac_config.h>
+#if !SSTMAC_INTEGRATED_SST_CORE
+#define __STDC_FORMAT_MACROS
+#include <sstmac/backends/native/link_fifo_event_map.h>
+#include <algorithm>
+#include <limits>
+#include <cinttypes>
+
+namespace sstmac {
+namespace native {
+
+LinkFifoEventMap::LinkFifoEventMap(SST::Params& params, ParallelRuntime* rt) :
+  EventManager(params, rt)
+{
+  if (nproc_ > 1 || nthread_ > 1){
+    spkt_abort_printf("link_fifo event manager only supports serial runs, got %d procs and %d threads",
+                      nproc_, int(nthread_));
+  }
+}
+
+LinkFifoEventMap::~LinkFifoEventMap()
+{
+  for (Lane* l : link_lanes_) delete l;
+  for (Lane* l : self_lanes_) delete l;
+}
+
+LinkFifoEventMap::Lane*
+LinkFifoEventMap::lane(uint32_t linkId)
+{
+  //self link ids are allocated down from the max id
+  //keep them in a separate dense vector
+  uint32_t top = std::numeric_limits<uint32_t>::max();
+  std::vector<Lane*>* lanes = &link_lanes_;
+  uint32_t idx = linkId;
+  if (linkId > top / 2){
+    lanes = &self_lanes_;
+    idx = top - linkId;
+  }
+  if (idx >= lanes->size()){
+    lanes->resize(idx + 1, nullptr);
+  }
+  Lane*& l = (*lanes)[idx];
+  if (!l){
+    l = new Lane;
+  }
+  return l;
+}
+
+void
+LinkFifoEventMap::schedule(ExecutionEvent* ev)
+{
+#if SSTMAC_SANITY_CHECK
+  if (ev->time() < now_){
+    spkt_abort_printf("Time went backwards on manager %d:%d to t=%10.6e for link=%" PRIu32 " seq=%" PRIu32,
+                      me_, thread_id_, ev->time().sec(), ev->linkId(), ev->seqnum());
+  }
+#endif
+  Lane* l = lane(ev->linkId());
+  if (l->events.empty()){
+    l->events.push_back(ev);
+    heads_.push_back(l);
+    std::push_heap(heads_.begin(), heads_.end(), LaneCompare());
+  } else if (!EventCompare()(ev, l->events.back())){
+    //the common case, the event is the newest on its link
+    //appending does not change the head, so no heap update
+    l->events.push_back(ev);
+  } else {
+    //out-of-order arrival on this link
+    event_queue_.insert(ev);
+  }
+}
+
+ExecutionEvent*
+LinkFifoEventMap::nextEvent(bool& fromLane) const
+{
+  ExecutionEvent* laneEv = heads_.empty() ? nullptr : heads_.front()->events.front();
+  ExecutionEvent* queueEv = event_queue_.empty() ? nullptr : *event_queue_.begin();
+  if (!queueEv || (laneEv && EventCompare()(laneEv, queueEv))){
+    fromLane = true;
+    return laneEv;
+  } else {
+    fromLane = false;
+    return queueEv;
+  }
+}
+
+void
+LinkFifoEventMap::popLane()
+{
+  std::pop_heap(heads_.begin(), heads_.end(), LaneCompare());
+  Lane* l = heads_.back();
+  l->events.pop_front();
+  if (l->events.empty()){
+    heads_.pop_back();
+  } else {
+    std::push_heap(heads_.begin(), heads_.end(), LaneCompare());
+  }
+}
+
+Timestamp
+LinkFifoEventMap::minEventTime() const
+{
+  bool fromLane;
+  ExecutionEvent* ev = nextEvent(fromLane);
+  return ev ? ev->time() : no_events_left_time;
+}
+
+Timestamp
+LinkFifoEventMap::runEvents(Timestamp event_horizon)
+{
+  registerPending();
+  min_ipc_time_ = no_events_left_time;
+  bool fromLane;
+  while (ExecutionEvent* ev = nextEvent(fromLane)){
+#if SSTMAC_SANITY_CHECK
+    if (ev->time() < now_){
+      spkt_abort_printf("Time went backwards on manager %d:%d to t=%10.6e for link=%" PRIu32 " for seqnum=%" PRIu32,
+                        me_, thread_id_, ev->time().sec(), ev->linkId(), ev->seqnum());
+    }
+#endif
+    if (ev->time() >= event_horizon){
+      return std::min(min_ipc_time_, ev->time());
+    }
+    now_ = ev->time();
+    if (fromLane){
+      popLane();
+    } else {
+      event_queue_.erase(event_queue_.begin());
+    }
+    ev->execute();
+    delete ev;
+  }
+  return min_ipc_time_;
+}
+
+void
+LinkFifoEventMap::clearEvents()
+{
+  for (Lane* l : heads_){
+    for (ExecutionEvent* ev : l->events){
+      delete ev;
+    }
+    l->events.clear();
+  }
+  heads_.clear();
+  EventManager::clearEvents();
+}
+
+}
+}
+
+#endif // !SSTMAC_INTEGRATED_SST_CORE
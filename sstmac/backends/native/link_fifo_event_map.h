@@ -0,0 +1,140 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+
+#ifndef SSTMAC_BACKENDS_NATIVE_LINK_FIFO_EVENT_MAP_H_INCLUDED
+#define SSTMAC_BACKENDS_NATIVE_LINK_FIFO_EVENT_MAP_H_INCLUDED
+
+#include <sstmac/common/sstmac_config.h>
+#if !SSTMAC_INTEGRATED_SST_CORE
+
+#include <sstmac/common/event_manager.h>
+#include <vector>
+#include <deque>
+
+namespace sstmac {
+namespace native {
+
+/**
+ * @brief The LinkFifoEventMap class
+ * Events sent over a link almost always arrive in (time, seqnum) order.
+ * Rather than inserting every event into one global ordered set,
+ * each link keeps a FIFO of its pending events and only the heads
+ * of the non-empty FIFOs are ordered in a binary heap.
+ * The heap therefore holds about as many entries as there are active links.
+ * Events that arrive out of order on their link (e.g. self events
+ * with variable delays) fall back to the ordered set of the map event manager.
+ * The global ordering is identical to the map event manager.
+ */
+class LinkFifoEventMap :
+  public EventManager
+{
+ public:
+  SST_ELI_REGISTER_DERIVED(
+    EventManager,
+    LinkFifoEventMap,
+    "macro",
+    "link_fifo",
+    SST_ELI_ELEMENT_VERSION(1,0,0),
+    "Implements a serial event manager with per-link FIFOs merged by a heap")
+
+  LinkFifoEventMap(SST::Params& params, ParallelRuntime* rt);
+
+  ~LinkFifoEventMap() override;
+
+  void schedule(ExecutionEvent* ev) override;
+
+  Timestamp runEvents(Timestamp event_horizon) override;
+
+  Timestamp minEventTime() const override;
+
+ protected:
+  void clearEvents() override;
+
+ private:
+  struct Lane {
+    /** Events ordered by EventCompare */
+    std::deque<ExecutionEvent*> events;
+  };
+
+  struct LaneCompare {
+    //std heap functions build a max-heap, invert for earliest head on top
+    bool operator()(Lane* lhs, Lane* rhs) const {
+      return EventCompare()(rhs->events.front(), lhs->events.front());
+    }
+  };
+
+  Lane* lane(uint32_t linkId);
+
+  /**
+   * @brief nextEvent
+   * @param fromLane [out] Whether the event is at the head of a lane or in the overflow queue
+   * @return The earliest pending event across the lane heads and the overflow queue,
+   *         nullptr if there are no events
+   */
+  ExecutionEvent* nextEvent(bool& fromLane) const;
+
+  /**
+   * @brief popLane
+   * Remove the first event of the lane at the top of the heap
+   */
+  void popLane();
+
+  /** Lanes for interconnect links, which are numbered up from zero */
+  std::vector<Lane*> link_lanes_;
+
+  /** Lanes for self links, which are numbered down from the top of the id space */
+  std::vector<Lane*> self_lanes_;
+
+  /** The non-empty lanes, heap ordered by their first event */
+  std::vector<Lane*> heads_;
+
+};
+
+}
+}
+
+#endif // !SSTMAC_INTEGRATED_SST_CORE
+
+#endif
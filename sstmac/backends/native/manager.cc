@@ -49,6 +49,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/backends/common/sim_partition.h>
 #include <sstmac/backends/native/manager.h>
 #include <sstmac/backends/native/clock_cycle_event_container.h>
+#include <sstmac/backends/native/checkpoint.h>
 
 #include <sstmac/common/runtime.h>
 
@@ -239,7 +240,8 @@ class TimestampPrefixFxn :
 //
 Manager::Manager(SST::Params& params, ParallelRuntime* rt) :
   interconnect_(nullptr),
-  rt_(rt)
+  rt_(rt),
+  checkpoint_(nullptr)
 {
   std::string event_man = "map";
   if (rt_->nthread() > 1){
@@ -267,6 +269,10 @@ Manager::Manager(SST::Params& params, ParallelRuntime* rt) :
   interconnect_ = hw::Interconnect::staticInterconnect(params, EventManager_);
 
   EventManager_->setInterconnect(interconnect_);
+
+  if (Checkpoint::requested(params)){
+    checkpoint_ = new Checkpoint(params);
+  }
 }
 
 Manager::~Manager() throw ()
@@ -277,6 +283,7 @@ Manager::~Manager() throw ()
     abort();
   }
   if (EventManager_) delete EventManager_;
+  if (checkpoint_) delete checkpoint_;
 }
 
 void
@@ -300,6 +307,10 @@ Manager::run(Timestamp until)
     EventManager_->scheduleStop(until);
   }
 
+  if (checkpoint_){
+    checkpoint_->schedule(EventManager_);
+  }
+
   //this is a little convoluted here, but necessary
   //to make multithreading easier
   EventManager_->spinUp(runManager, EventManager_);
@@ -58,6 +58,8 @@ DeclareDebugSlot(timestamp);
 namespace sstmac {
 namespace native {
 
+class Checkpoint;
+
 /**
  * The owner of a discrete-event network simulation.
  *
@@ -95,6 +97,7 @@ class Manager {
 
   sstmac::hw::Interconnect* interconnect_;
   ParallelRuntime* rt_;
+  Checkpoint* checkpoint_;
 #endif
 };
 
@@ -53,9 +53,10 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <iostream>
 #include <sstream>
 #include <limits>
+#include <algorithm>
 #include <sstmac/hardware/interconnect/interconnect.h>
+#include <sstmac/backends/common/sim_partition.h>
 #include <sprockit/keyword_registration.h>
-#include <sprockit/thread_safe.h>
 #include <cinttypes>
 
 RegisterDebugSlot(multithread);
@@ -63,69 +64,34 @@ RegisterDebugSlot(cpu_affinity);
 
 RegisterKeywords(
  { "cpu_affinity", "the CPU offset for binding threads to core" },
+ { "rebalance_epochs", "the number of epochs to profile event costs before migrating switches between threads" },
+ { "rebalance_count", "the number of times to profile and migrate switches between threads" },
 );
 
-static int busy_loop_count = 200;
-static int epoch_print_interval = 10000;
-
-static uint64_t event_cycles = 0;
-static uint64_t barrier_cycles = 0;
-
-static inline void busy_loop(){
-  //checking back often enough - but without thrashing the variable
-  for (int i=0; i < busy_loop_count; ++i){
-    __asm__ __volatile__("");
-  }
-}
-
-static int64_t terminate_sentinel = std::numeric_limits<int64_t>::max();
-
 namespace sstmac {
 namespace native {
 
-#define atomic_is_zero(x) \
-  (add_int64_atomic(int32_t(0), x) == 0)
-  //*x == 0
-
-static inline void wait_on_child_completion(threadQueue* q, Timestamp& min_time)
-{
-  bool done = atomic_is_zero(q->delta_t);
-  while (!done){
-    busy_loop(); //don't slam the variable too hard
-    done = atomic_is_zero(q->delta_t);
-  }
-  min_time = std::min(min_time, q->min_time);
-}
-
 static void
 pthread_run_worker_thread(void* args)
 {
   threadQueue* q = (threadQueue*) args;
-  Timestamp horizon;
-  uint64_t epoch = 0;
   debug_printf(sprockit::dbg::parallel, "spun up subthread");
   while(1){
-    bool stillZero = atomic_is_zero(q->delta_t);
-    if (!stillZero){
-      int64_t delta_t = *q->delta_t;
-      if (q->child1) add_int64_atomic(delta_t, q->child1->delta_t);
-      if (q->child2) add_int64_atomic(delta_t, q->child2->delta_t);
-      if (delta_t == terminate_sentinel){
-        return;
-      } else if (delta_t != 0) {
-        horizon += TimeDelta(delta_t, TimeDelta::exact);
-        Timestamp new_min_time = q->mgr->runEvents(horizon);
-        debug_printf(sprockit::dbg::parallel, "manager %d:%d voting for minimum time %10.7e on epoch %d",
-                    q->mgr->me(), q->mgr->thread(), new_min_time.sec(), q->mgr->epoch());
-        q->min_time = new_min_time;
-      }
-      if (q->child1) wait_on_child_completion(q->child1, q->min_time);
-      if (q->child2) wait_on_child_completion(q->child2, q->min_time);
-      add_int64_atomic(-delta_t, q->delta_t);
-      ++epoch;
-    } else {
-      busy_loop(); //don't slam the variable too hard
+    auto t_start = rdtsc();
+    //wait for the main thread to release the next epoch
+    q->barrier->wait(q->thread);
+    if (q->terminate){
+      return;
     }
+    auto t_run = rdtsc();
+    q->min_time = q->mgr->runEvents(q->horizon);
+    debug_printf(sprockit::dbg::parallel, "manager %d:%d voting for minimum time %10.7e on epoch %d",
+                q->mgr->me(), q->mgr->thread(), q->min_time.sec(), q->mgr->epoch());
+    auto t_done = rdtsc();
+    //signal the main thread that the epoch is complete
+    q->barrier->wait(q->thread);
+    auto t_stop = rdtsc();
+    q->stats.addEpoch(t_done - t_run, (t_run - t_start) + (t_stop - t_done));
   }
   return;
 }
@@ -139,7 +105,8 @@ spin_up_pthread_work(void* args){
 
 MultithreadedEventContainer::MultithreadedEventContainer(
   SST::Params& params, ParallelRuntime* rt) :
-  ClockCycleEventMap(params, rt)
+  ClockCycleEventMap(params, rt),
+  barrier_(nullptr)
 {
   //set the signal handler
   //signal(SIGSEGV, print_backtrace);
@@ -155,10 +122,17 @@ MultithreadedEventContainer::MultithreadedEventContainer(
     //it would be nice to check that size of cpu_offsets matches task per node
   }
 
-  busy_loop_count = params.find<int>("busy_loop_count", busy_loop_count);
-
   num_subthreads_ = rt->nthread() - 1;
 
+  rebalance_epochs_ = params.find<int>("rebalance_epochs", 0);
+  rebalance_count_ = params.find<int>("rebalance_count", 1);
+  if (rebalance_epochs_ > 0 && rebalance_count_ > 0 && num_subthreads_ > 0){
+    if (nproc_ > 1){
+      sprockit::abort("rebalance_epochs: migrating switches between threads requires a single rank");
+    }
+    allow_migration_ = true;
+  }
+
   queues_.resize(num_subthreads_);
   pthreads_.resize(num_subthreads_);
   pthread_attrs_.resize(num_subthreads_);
@@ -170,9 +144,17 @@ MultithreadedEventContainer::MultithreadedEventContainer(
   }
   setThread(num_subthreads_);
 
+  auto barrier_type = params.find<std::string>("thread_barrier", "tree");
+  barrier_ = sprockit::create<ThreadBarrier>("macro", barrier_type, params, nthread());
+
   for (int i=0; i < queues_.size(); ++i){
-    queues_[i].mgr = thread_managers_[i];
+    threadQueue& q = queues_[i];
+    q.mgr = thread_managers_[i];
+    q.barrier = barrier_;
+    q.thread = i;
+    registerEpochStats(params, i, q.stats);
   }
+  registerEpochStats(params, num_subthreads_, epoch_stats_);
 
   for (int i=0; i < num_subthreads_; ++i){
     int status = pthread_attr_init(&pthread_attrs_[i]);
@@ -182,6 +164,11 @@ MultithreadedEventContainer::MultithreadedEventContainer(
   }
 }
 
+MultithreadedEventContainer::~MultithreadedEventContainer() throw ()
+{
+  if (barrier_) delete barrier_;
+}
+
 void
 MultithreadedEventContainer::scheduleStop(Timestamp until)
 {
@@ -193,41 +180,82 @@ MultithreadedEventContainer::scheduleStop(Timestamp until)
 }
 
 void
-MultithreadedEventContainer::runWork()
+MultithreadedEventContainer::computeThreadLookahead()
 {
-  //make the binary spanning tree for the thread barrier
-  threadQueue* child1 = nullptr;
-  threadQueue* child2 = nullptr;
-  if (num_subthreads_ >= 1){
-    child1 = &queues_[0]; 
+  int nthr = nthread();
+  thread_lookahead_.assign(nthr*nthr, 0);
+  for (int src=0; src < nthr; ++src){
+    for (int dst=0; dst < nthr; ++dst){
+      if (src == dst) continue;
+      int64_t lat;
+      if (allow_migration_){
+        //migrating switches changes which threads are linked, assume any pair can be
+        lat = lookahead_.ticks();
+      } else {
+        lat = threadManager(src)->minThreadLinkLatency(dst).ticks();
+      }
+      thread_lookahead_[src*nthr + dst] = lat;
+      debug_printf(sprockit::dbg::multithread,
+                   "rank %d thread %d->%d has lookahead %" PRId64 " ticks",
+                   me_, src, dst, lat);
+    }
   }
-  if (num_subthreads_ >= 2){
-    child2 = &queues_[1];
+}
+
+void
+MultithreadedEventContainer::computeHorizons(std::vector<Timestamp>& bounds,
+                                             Timestamp global_bound,
+                                             std::vector<Timestamp>& horizons)
+{
+  int nthr = nthread();
+  if (nproc_ > 1){
+    //events from other ranks are only bounded by the global vote
+    for (Timestamp& b : bounds){
+      b = std::min(b, global_bound);
+    }
   }
 
-  int last_level_offset = 0;
-  int level_offset = 2;
-  int level_size = 4;
-  while (level_offset < num_subthreads_){
-    int maxChild = std::min(level_offset+level_size,num_subthreads_);
-    for (int c=level_offset; c < maxChild; ++c){
-      int child_offset = c - level_offset;
-      int parent_offset = child_offset / 2;
-      int child_number = child_offset % 2;
-      int parent = last_level_offset + parent_offset;
-      threadQueue& parentQ = queues_[parent];
-      if (child_number == 0){
-        parentQ.child1 = &queues_[c];
-      } else {
-        parentQ.child2 = &queues_[c];
+  //events run on one thread can schedule events on other threads within the epoch,
+  //relax the bounds along the links until no bound changes
+  for (int round=0; round < nthr; ++round){
+    bool changed = false;
+    for (int src=0; src < nthr; ++src){
+      if (bounds[src] == no_events_left_time) continue;
+      for (int dst=0; dst < nthr; ++dst){
+        int64_t lat = thread_lookahead_[src*nthr + dst];
+        if (lat == 0) continue;
+        Timestamp t = bounds[src] + TimeDelta(lat, TimeDelta::exact);
+        if (t < bounds[dst]){
+          bounds[dst] = t;
+          changed = true;
+        }
       }
     }
-    last_level_offset = level_offset;
-    level_offset += level_size;
-    level_size *= 2;
+    if (!changed) break;
   }
-  
-  Timestamp last_horizon;
+
+  //each thread only has to wait on the threads and ranks with links into it
+  for (int dst=0; dst < nthr; ++dst){
+    Timestamp horizon = no_events_left_time;
+    if (nproc_ > 1 && global_bound != no_events_left_time){
+      horizon = global_bound + remote_lookahead_;
+    }
+    for (int src=0; src < nthr; ++src){
+      int64_t lat = thread_lookahead_[src*nthr + dst];
+      if (lat == 0 || bounds[src] == no_events_left_time) continue;
+      horizon = std::min(horizon, bounds[src] + TimeDelta(lat, TimeDelta::exact));
+    }
+    horizons[dst] = horizon;
+  }
+}
+
+void
+MultithreadedEventContainer::runWork()
+{
+  int nthr = nthread();
+  std::vector<Timestamp> bounds(nthr);
+  std::vector<Timestamp> horizons(nthr);
+  std::vector<Timestamp> last_horizons(nthr);
   Timestamp lower_bound;
   uint64_t epoch = 0;
   int num_loops_left = num_profile_loops_;
@@ -243,27 +271,55 @@ MultithreadedEventContainer::runWork()
   if (rt_->me() == 0){
     printf("Running parallel simulation with lookahead %10.6fus\n", lookahead_.usec());
   }
+  computeRemoteLookahead();
+  computeThreadLookahead();
+  int rebalances_left = allow_migration_ ? rebalance_count_ : 0;
+  uint64_t next_rebalance = rebalance_epochs_;
+  if (rebalances_left){
+    for (int t=0; t < nthr; ++t){
+      threadManager(t)->setProfileLinks(true);
+    }
+  }
   while (lower_bound != no_events_left_time || num_loops_left > 0){
-    Timestamp horizon = lower_bound + lookahead_;
-    int64_t delta_t = (horizon - last_horizon).ticks();
-    if (num_loops_left != 0){
-      if (delta_t == 0){
-        delta_t = 1;
+    computeHorizons(bounds, lower_bound, horizons);
+    bool advanced = false;
+    for (int t=0; t < nthr; ++t){
+      if (horizons[t] != last_horizons[t]){
+        advanced = true;
+      } else if (num_loops_left != 0 && horizons[t] != no_events_left_time){
+        horizons[t] += TimeDelta(1, TimeDelta::exact);
+        advanced = true;
       }
-    } else if (horizon == last_horizon){
+    }
+    if (!advanced && num_loops_left == 0){
       spkt_abort_printf("Time did not advance - caught in infinite time loop");
     }
 
-    if (child1) add_int64_atomic(delta_t, child1->delta_t);
-    if (child2) add_int64_atomic(delta_t, child2->delta_t);
-
     auto t_start = rdtsc();
-    Timestamp min_time = runEvents(horizon);
+    //release the workers for the next epoch
+    for (threadQueue& q : queues_){
+      q.horizon = horizons[q.thread];
+    }
+    barrier_->wait(num_subthreads_);
 
     auto t_run = rdtsc();
+    bounds[num_subthreads_] = runEvents(horizons[num_subthreads_]);
+    auto t_done = rdtsc();
 
-    if (child1) wait_on_child_completion(child1, min_time);
-    if (child2) wait_on_child_completion(child2, min_time);
+    //wait for the workers to complete the epoch
+    barrier_->wait(num_subthreads_);
+    for (threadQueue& q : queues_){
+      bounds[q.thread] = q.min_time;
+    }
+    //events sent between threads this epoch are not yet in the destination queue
+    for (int src=0; src < nthr; ++src){
+      EventManager* mgr = threadManager(src);
+      for (int dst=0; dst < nthr; ++dst){
+        bounds[dst] = std::min(bounds[dst], mgr->minThreadSendTime(dst));
+      }
+      mgr->clearMinThreadSendTimes();
+    }
+    Timestamp min_time = *std::min_element(bounds.begin(), bounds.end());
 
     if (stopped_){
       lower_bound = no_events_left_time; //done
@@ -271,13 +327,20 @@ MultithreadedEventContainer::runWork()
       lower_bound = receiveIncomingEvents(min_time);
     }
     if (num_loops_left > 0) --num_loops_left;
-    last_horizon = horizon;
+    last_horizons = horizons;
+    if (rebalances_left && (epoch+1) == next_rebalance && lower_bound != no_events_left_time){
+      rebalance(epoch);
+      --rebalances_left;
+      next_rebalance += rebalance_epochs_;
+      for (int t=0; t < nthr; ++t){
+        threadManager(t)->clearLinkCycles();
+        threadManager(t)->setProfileLinks(rebalances_left > 0);
+      }
+    }
     auto t_stop = rdtsc();
-    uint64_t event = t_run - t_start;
-    uint64_t barrier = t_stop - t_run;
-    event_cycles += event;
-    barrier_cycles += barrier;
-    if (epoch % epoch_print_interval == 0 && rt_->me() == 0){
+    epoch_stats_.addEpoch(t_done - t_run, (t_run - t_start) + (t_stop - t_done));
+    if (epoch % epoch_print_interval_ == 0 && rt_->me() == 0){
+      Timestamp horizon = horizons[num_subthreads_];
       debug_printf(sprockit::dbg::multithread,
            "Epoch %-10" PRIu64 " ran until horizon %" PRIu64 ":%" PRIu64 " - new bound = %" PRIu64 ":%" PRIu64 "\n",
            epoch, horizon.epochs, horizon.time.ticks(), lower_bound.epochs, lower_bound.time.ticks());
@@ -286,13 +349,89 @@ MultithreadedEventContainer::runWork()
     ++epoch;
   }
 
-  if (child1) add_int64_atomic(terminate_sentinel, child1->delta_t);
-  if (child2) add_int64_atomic(terminate_sentinel, child2->delta_t);
+  for (threadQueue& q : queues_){
+    q.terminate = true;
+  }
+  barrier_->wait(num_subthreads_);
 
   if (rt_->me() == 0) printf("Ran %" PRIu64 " epochs in multithreading run\n", epoch);
 
 }
 
+void
+MultithreadedEventContainer::rebalance(uint64_t epoch)
+{
+  int nthr = nthread();
+  std::vector<uint64_t> load(nthr);
+  for (int t=0; t < nthr; ++t){
+    load[t] = threadManager(t)->profiledCycles();
+  }
+
+  //nodes stay on their thread, only switches are migrated
+  Partition* part = topologyPartition();
+  const auto& switches = interconn_->switches();
+  std::vector<uint64_t> cost(switches.size(), 0);
+  std::vector<int> old_thread(switches.size(), -1);
+  std::vector<uint32_t> links;
+  for (int s=0; s < switches.size(); ++s){
+    if (!switches[s]) continue;
+    int thr = part->threadForSwitch(s);
+    EventManager* mgr = threadManager(thr);
+    links.clear();
+    interconn_->switchLinks(s, links);
+    for (uint32_t link : links){
+      cost[s] += mgr->linkCycles(link);
+    }
+    old_thread[s] = thr;
+  }
+
+  uint64_t total = 0;
+  for (uint64_t l : load) total += l;
+  if (total == 0) return;
+  double avg = double(total) / nthr;
+  uint64_t max_before = *std::max_element(load.begin(), load.end());
+
+  //repeatedly move the switch that best evens out the most and least loaded threads,
+  //each move strictly reduces the sum of squared loads so this terminates
+  std::vector<int> new_thread(old_thread);
+  int max_moves = switches.size();
+  for (int m=0; m < max_moves; ++m){
+    int hi = std::max_element(load.begin(), load.end()) - load.begin();
+    int lo = std::min_element(load.begin(), load.end()) - load.begin();
+    uint64_t gap = load[hi] - load[lo];
+    int best = -1;
+    uint64_t best_gap = gap;
+    for (int s=0; s < switches.size(); ++s){
+      if (new_thread[s] != hi || cost[s] == 0 || cost[s] >= gap) continue;
+      uint64_t twice = 2*cost[s];
+      uint64_t new_gap = twice > gap ? twice - gap : gap - twice;
+      if (new_gap < best_gap){
+        best_gap = new_gap;
+        best = s;
+      }
+    }
+    if (best < 0) break;
+    load[hi] -= cost[best];
+    load[lo] += cost[best];
+    new_thread[best] = lo;
+  }
+
+  int num_moved = 0;
+  for (int s=0; s < switches.size(); ++s){
+    if (new_thread[s] != old_thread[s]){
+      interconn_->migrateSwitch(s, new_thread[s]);
+      ++num_moved;
+    }
+  }
+
+  uint64_t max_after = *std::max_element(load.begin(), load.end());
+  if (rt_->me() == 0){
+    printf("Rebalanced threads after epoch %" PRIu64 ": migrated %d switches, max/avg thread load %5.3f -> %5.3f\n",
+           epoch, num_moved, max_before / avg, max_after / avg);
+    fflush(stdout);
+  }
+}
+
 void
 MultithreadedEventContainer::run()
 {
@@ -375,6 +514,8 @@ MultithreadedEventContainer::run()
   }
 
   computeFinalTime(final_time);
+
+  finalizeStatsOutput();
 }
 
 
@@ -49,6 +49,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #if !SSTMAC_INTEGRATED_SST_CORE
 
 #include <sstmac/backends/native/clock_cycle_event_container.h>
+#include <sstmac/backends/native/thread_barrier.h>
 #include <pthread.h>
 #include <stdlib.h>
 
@@ -64,24 +65,21 @@ struct threadQueue
 {
   threadQueue() :
     mgr(nullptr),
-    child1(nullptr),
-    child2(nullptr)
+    barrier(nullptr),
+    terminate(false),
+    thread(0)
   {
-    void* ptr = &delta_t;
-    int rc = posix_memalign((void**)ptr, sizeof(void*), sizeof(int64_t));
-    if (rc != 0){
-      spkt_abort_printf("Failed to allocated aligned memory: %d\n%s",
-                        rc, ::strerror(rc));
-    }
-    *delta_t = 0;
   }
 
-  volatile int64_t* delta_t;
   Timestamp min_time;
+  /** Written by the main thread before releasing the worker each epoch */
+  Timestamp horizon;
   EventManager* mgr;
-  threadQueue* child1;
-  threadQueue* child2;
-
+  ThreadBarrier* barrier;
+  /** Written by the main thread before releasing the worker for the last time */
+  bool terminate;
+  int thread;
+  EpochStats stats;
 };
 
 
@@ -99,7 +97,7 @@ class MultithreadedEventContainer :
 
   MultithreadedEventContainer(SST::Params& params, ParallelRuntime* rt);
 
-  ~MultithreadedEventContainer() throw () override {}
+  ~MultithreadedEventContainer() throw () override;
 
   void run() override;
 
@@ -120,6 +118,44 @@ class MultithreadedEventContainer :
 
   void runWork();
 
+  /**
+   * @brief rebalance
+   * Use the event costs profiled since the last rebalance to
+   * migrate switches from the most to the least loaded threads.
+   * Must only be called between epochs while the subthreads are waiting.
+   * @param epoch The epoch just completed
+   */
+  void rebalance(uint64_t epoch);
+
+  /** The number of epochs to profile before each rebalance, zero to never rebalance */
+  int rebalance_epochs_;
+
+  /** The number of times to rebalance */
+  int rebalance_count_;
+
+  /**
+   * @brief computeThreadLookahead
+   * Fill the matrix of minimum link latencies between the threads of this rank.
+   * Must be called after the interconnect has been built.
+   */
+  void computeThreadLookahead();
+
+  /**
+   * @brief computeHorizons
+   * Compute the horizon for each thread from the lower bounds on the events
+   * each thread will run and the link latencies into the thread
+   * @param bounds The earliest event queued on or sent to each thread
+   * @param global_bound The earliest event across all ranks
+   * @param horizons [out] The time up to which each thread can safely run
+   */
+  void computeHorizons(std::vector<Timestamp>& bounds, Timestamp global_bound,
+                       std::vector<Timestamp>& horizons);
+
+  ThreadBarrier* barrier_;
+
+  /** Minimum link latency in ticks from row thread to column thread, zero if no link */
+  std::vector<int64_t> thread_lookahead_;
+
   std::vector<threadQueue> queues_;
   std::vector<int> cpu_affinity_;
   std::vector<pthread_t> pthreads_;
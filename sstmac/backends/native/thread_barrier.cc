@@ -0,0 +1,229 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+
+#include <sstmac/common/sstmac_config.h>
+#if !SSTMAC_INTEGRATED_SST_CORE
+#include <sstmac/backends/native/thread_barrier.h>
+#include <sprockit/sim_parameters.h>
+#include <sprockit/keyword_registration.h>
+#include <sprockit/errors.h>
+#include <algorithm>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+RegisterKeywords(
+ { "thread_barrier", "the barrier (tree, dissemination, sense_reversal) used to synchronize threads each epoch" },
+ { "thread_barrier_min_spin", "the fewest iterations a thread spins in a barrier before sleeping" },
+ { "thread_barrier_max_spin", "the most iterations a thread spins in a barrier before sleeping" },
+);
+
+namespace sstmac {
+namespace native {
+
+static inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __asm__ __volatile__("pause");
+#else
+  __asm__ __volatile__("");
+#endif
+}
+
+static inline bool reached(uint32_t value, uint32_t episode)
+{
+  //episodes wrap around, compare the signed distance
+  return int32_t(value - episode) >= 0;
+}
+
+static inline void futex_wait(std::atomic<uint32_t>* addr, uint32_t expected)
+{
+#ifdef __linux__
+  //returns immediately if the value no longer matches
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+  std::this_thread::yield();
+#endif
+}
+
+static inline void futex_wake(std::atomic<uint32_t>* addr)
+{
+#ifdef __linux__
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+ThreadBarrier::ThreadBarrier(SST::Params& params, int nthread) :
+  nthread_(nthread),
+  threads_(nthread)
+{
+  min_spin_ = params.find<int>("thread_barrier_min_spin", 64);
+  max_spin_ = params.find<int>("thread_barrier_max_spin", 1<<16);
+  if (min_spin_ > max_spin_){
+    spkt_abort_printf("thread_barrier_min_spin=%u is larger than thread_barrier_max_spin=%u",
+                      min_spin_, max_spin_);
+  }
+  for (ThreadState& st : threads_){
+    st.spins = max_spin_;
+  }
+}
+
+void
+ThreadBarrier::post(BarrierFlag& flag, uint32_t episode)
+{
+  //the store must be ordered before checking for sleepers,
+  //pairs with the sleeper registering before re-checking the value in the kernel
+  flag.value.store(episode, std::memory_order_seq_cst);
+  if (flag.sleepers.load(std::memory_order_seq_cst) > 0){
+    futex_wake(&flag.value);
+  }
+}
+
+void
+ThreadBarrier::waitFor(int thread, BarrierFlag& flag, uint32_t episode)
+{
+  ThreadState& st = threads_[thread];
+  for (uint32_t i=0; i < st.spins; ++i){
+    if (reached(flag.value.load(std::memory_order_acquire), episode)){
+      //spinning paid off, allow longer spins next time
+      st.spins = std::min(max_spin_, std::max(st.spins, 2*i));
+      return;
+    }
+    cpu_relax();
+  }
+
+  ++st.sleeps;
+  while (true){
+    uint32_t value = flag.value.load(std::memory_order_seq_cst);
+    if (reached(value, episode)) break;
+    flag.sleepers.fetch_add(1, std::memory_order_seq_cst);
+    futex_wait(&flag.value, value);
+    flag.sleepers.fetch_sub(1, std::memory_order_seq_cst);
+  }
+  //spinning was wasted, give up sooner next time
+  st.spins = std::max(min_spin_, st.spins / 2);
+}
+
+TreeBarrier::TreeBarrier(SST::Params& params, int nthread) :
+  ThreadBarrier(params, nthread),
+  arrived_(nthread),
+  released_(nthread)
+{
+}
+
+void
+TreeBarrier::wait(int thread)
+{
+  uint32_t episode = nextEpisode(thread);
+  //the last thread is the main thread - make it the root
+  int node = (thread + 1) % nthread_;
+  int child1 = 2*node + 1;
+  int child2 = 2*node + 2;
+
+  if (child1 < nthread_) waitFor(thread, arrived_[child1], episode);
+  if (child2 < nthread_) waitFor(thread, arrived_[child2], episode);
+  if (node != 0){
+    post(arrived_[node], episode);
+    waitFor(thread, released_[node], episode);
+  }
+  if (child1 < nthread_) post(released_[child1], episode);
+  if (child2 < nthread_) post(released_[child2], episode);
+}
+
+static int num_dissemination_rounds(int nthread)
+{
+  int rounds = 0;
+  while ((1<<rounds) < nthread){
+    ++rounds;
+  }
+  return rounds;
+}
+
+DisseminationBarrier::DisseminationBarrier(SST::Params& params, int nthread) :
+  ThreadBarrier(params, nthread),
+  num_rounds_(num_dissemination_rounds(nthread)),
+  flags_(nthread*num_rounds_)
+{
+}
+
+void
+DisseminationBarrier::wait(int thread)
+{
+  uint32_t episode = nextEpisode(thread);
+  for (int r=0; r < num_rounds_; ++r){
+    int partner = (thread + (1<<r)) % nthread_;
+    //each flag has a single writer that posts increasing episodes
+    post(flags_[partner*num_rounds_ + r], episode);
+    waitFor(thread, flags_[thread*num_rounds_ + r], episode);
+  }
+}
+
+SenseReversalBarrier::SenseReversalBarrier(SST::Params& params, int nthread) :
+  ThreadBarrier(params, nthread)
+{
+}
+
+void
+SenseReversalBarrier::wait(int thread)
+{
+  uint32_t episode = nextEpisode(thread);
+  uint32_t arrived = count_.value.fetch_add(1, std::memory_order_acq_rel) + 1;
+  if (arrived == uint32_t(nthread_)){
+    //nobody can arrive for the next episode until released
+    count_.value.store(0, std::memory_order_relaxed);
+    post(release_, episode);
+  } else {
+    waitFor(thread, release_, episode);
+  }
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,241 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+
+#ifndef SSTMAC_BACKENDS_NATIVE_THREAD_BARRIER_H_INCLUDED
+#define SSTMAC_BACKENDS_NATIVE_THREAD_BARRIER_H_INCLUDED
+
+#include <sstmac/common/sstmac_config.h>
+#if !SSTMAC_INTEGRATED_SST_CORE
+
+#include <sprockit/factory.h>
+#include <sprockit/sim_parameters_fwd.h>
+#include <sstmac/sst_core/integrated_component.h>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+
+namespace sstmac {
+namespace native {
+
+/**
+ * @brief The BarrierFlag struct
+ * A word that threads can block on until it reaches a given barrier episode.
+ * Padded to a cache line so that flags for different threads do not false share.
+ */
+struct BarrierFlag {
+  BarrierFlag() : value(0), sleepers(0) {}
+
+  std::atomic<uint32_t> value;
+  std::atomic<uint32_t> sleepers;
+  char padding[64 - 2*sizeof(std::atomic<uint32_t>)];
+};
+
+/**
+ * @brief The ThreadBarrier class
+ * Synchronizes the worker threads of a multithreaded simulation.
+ * Waiting threads spin for an adaptive number of iterations and then
+ * sleep on a futex (or yield on platforms without futexes),
+ * so that oversubscribed or shared cores are not burned while waiting.
+ * The spin budget grows while barriers complete during the spin
+ * and shrinks whenever a thread has to sleep.
+ */
+class ThreadBarrier
+{
+ public:
+  SST_ELI_DECLARE_BASE(ThreadBarrier)
+  SST_ELI_DECLARE_DEFAULT_INFO()
+  SST_ELI_DECLARE_CTOR(SST::Params&, int)
+
+  virtual ~ThreadBarrier(){}
+
+  /**
+   * @brief wait
+   * Block until all threads have called wait for this episode.
+   * Writes before the barrier on any thread are visible after the barrier on every thread.
+   * @param thread A thread in [0,nthread)
+   */
+  virtual void wait(int thread) = 0;
+
+  int nthread() const {
+    return nthread_;
+  }
+
+  /**
+   * @param thread
+   * @return The number of times the thread had to sleep in a barrier
+   */
+  uint64_t numSleeps(int thread) const {
+    return threads_[thread].sleeps;
+  }
+
+ protected:
+  ThreadBarrier(SST::Params& params, int nthread);
+
+  /**
+   * @param thread
+   * @return The episode number the thread is entering
+   */
+  uint32_t nextEpisode(int thread){
+    return ++threads_[thread].episode;
+  }
+
+  /**
+   * @brief waitFor
+   * Block until the flag has been posted for the episode
+   * @param thread The thread that is waiting
+   * @param flag
+   * @param episode
+   */
+  void waitFor(int thread, BarrierFlag& flag, uint32_t episode);
+
+  /**
+   * @brief post
+   * Mark the flag as reached for the episode and wake any threads sleeping on it
+   * @param flag
+   * @param episode
+   */
+  static void post(BarrierFlag& flag, uint32_t episode);
+
+  int nthread_;
+
+ private:
+  struct ThreadState {
+    ThreadState() : episode(0), spins(0), sleeps(0) {}
+    uint32_t episode;
+    uint32_t spins;
+    uint64_t sleeps;
+    char padding[64 - 2*sizeof(uint32_t) - sizeof(uint64_t)];
+  };
+
+  std::vector<ThreadState> threads_;
+  uint32_t min_spin_;
+  uint32_t max_spin_;
+};
+
+/**
+ * @brief The TreeBarrier class
+ * Combining binary tree. Arrivals are gathered up the tree and the
+ * release is fanned back down, so each thread only touches the flags of
+ * its parent and children. Thread nthread-1 (the main thread) is the root.
+ */
+class TreeBarrier : public ThreadBarrier
+{
+ public:
+  SST_ELI_REGISTER_DERIVED(
+    ThreadBarrier,
+    TreeBarrier,
+    "macro",
+    "tree",
+    SST_ELI_ELEMENT_VERSION(1,0,0),
+    "binary combining tree barrier rooted at the main thread")
+
+  TreeBarrier(SST::Params& params, int nthread);
+
+  void wait(int thread) override;
+
+ private:
+  std::vector<BarrierFlag> arrived_;
+  std::vector<BarrierFlag> released_;
+};
+
+/**
+ * @brief The DisseminationBarrier class
+ * Completes in ceil(log2(nthread)) rounds. In round r every thread
+ * signals thread (me + 2^r) % nthread and waits on its own flag,
+ * so there is no single thread that everyone waits on.
+ */
+class DisseminationBarrier : public ThreadBarrier
+{
+ public:
+  SST_ELI_REGISTER_DERIVED(
+    ThreadBarrier,
+    DisseminationBarrier,
+    "macro",
+    "dissemination",
+    SST_ELI_ELEMENT_VERSION(1,0,0),
+    "dissemination barrier with log2(nthread) rounds of pairwise signals")
+
+  DisseminationBarrier(SST::Params& params, int nthread);
+
+  void wait(int thread) override;
+
+ private:
+  int num_rounds_;
+  /** Indexed by thread*num_rounds_ + round */
+  std::vector<BarrierFlag> flags_;
+};
+
+/**
+ * @brief The SenseReversalBarrier class
+ * Centralized barrier on a shared arrival counter.
+ * The last thread to arrive resets the counter and releases everyone
+ * by advancing the episode, which plays the role of the flipped sense.
+ */
+class SenseReversalBarrier : public ThreadBarrier
+{
+ public:
+  SST_ELI_REGISTER_DERIVED(
+    ThreadBarrier,
+    SenseReversalBarrier,
+    "macro",
+    "sense_reversal",
+    SST_ELI_ELEMENT_VERSION(1,0,0),
+    "centralized counter barrier with sense reversal")
+
+  SenseReversalBarrier(SST::Params& params, int nthread);
+
+  void wait(int thread) override;
+
+ private:
+  BarrierFlag count_;
+  BarrierFlag release_;
+};
+
+}
+}
+
+#endif // !SSTMAC_INTEGRATED_SST_CORE
+
+#endif // SSTMAC_BACKENDS_NATIVE_THREAD_BARRIER_H_INCLUDED
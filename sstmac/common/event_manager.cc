@@ -57,6 +57,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sprockit/output.h>
 #include <sprockit/thread_safe_new.h>
 #include <limits>
+#include <algorithm>
 
 #include <cinttypes>
 
@@ -111,10 +112,16 @@ EventManager::EventManager(SST::Params& params, ParallelRuntime *rt) :
   rt_(rt),
   interconn_(nullptr),
   stopped_(false),
+  allow_migration_(false),
   me_(rt->me()),
   nproc_(rt->nproc()),
   nthread_(rt->nthread()),
-  thread_id_(0)
+  thread_id_(0),
+  profile_links_(false),
+  profiled_cycles_(0),
+  min_thread_send_time_(nthread_, no_events_left_time),
+  thread_link_latency_(nthread_),
+  rank_link_latency_(nproc_)
 {
   for (int i=0; i < num_pendingSlots; ++i){
     pending_events_[i].resize(nthread_);
@@ -156,16 +163,152 @@ EventManager::addLinkHandler(uint64_t linkId, EventHandler *handler)
   link_handlers_[linkId] = handler;
 }
 
+void
+EventManager::clearMinThreadSendTimes()
+{
+  for (Timestamp& t : min_thread_send_time_){
+    t = no_events_left_time;
+  }
+}
+
+void
+EventManager::addThreadLinkLatency(int thread, TimeDelta latency)
+{
+  TimeDelta& lat = thread_link_latency_[thread];
+  if (lat.ticks() == 0 || latency < lat){
+    lat = latency;
+  }
+}
+
+void
+EventManager::addRankLinkLatency(int rank, TimeDelta latency)
+{
+  TimeDelta& lat = rank_link_latency_[rank];
+  if (lat.ticks() == 0 || latency < lat){
+    lat = latency;
+  }
+}
+
 void
 EventManager::stop()
 {
   printf("Shutting down simulation at t=%20.12fs\n", now().sec());
+  clearEvents();
+  min_ipc_time_ = no_events_left_time;
+  stopped_ = true;
+}
+
+void
+EventManager::clearEvents()
+{
   for (ExecutionEvent* ev : event_queue_){
     delete ev;
   }
   event_queue_.clear();
-  min_ipc_time_ = no_events_left_time;
-  stopped_ = true;
+}
+
+uint64_t&
+EventManager::linkCycleCounter(uint32_t linkId)
+{
+  //self link ids are allocated down from the max id
+  uint32_t top = std::numeric_limits<uint32_t>::max();
+  std::vector<uint64_t>* cycles = &link_cycles_;
+  uint32_t idx = linkId;
+  if (linkId > top / 2){
+    cycles = &self_link_cycles_;
+    idx = top - linkId;
+  }
+  if (idx >= cycles->size()){
+    cycles->resize(idx + 1, 0);
+  }
+  return (*cycles)[idx];
+}
+
+uint64_t
+EventManager::linkCycles(uint32_t linkId) const
+{
+  uint32_t top = std::numeric_limits<uint32_t>::max();
+  const std::vector<uint64_t>* cycles = &link_cycles_;
+  uint32_t idx = linkId;
+  if (linkId > top / 2){
+    cycles = &self_link_cycles_;
+    idx = top - linkId;
+  }
+  return idx < cycles->size() ? (*cycles)[idx] : 0;
+}
+
+void
+EventManager::clearLinkCycles()
+{
+  std::fill(link_cycles_.begin(), link_cycles_.end(), 0);
+  std::fill(self_link_cycles_.begin(), self_link_cycles_.end(), 0);
+  profiled_cycles_ = 0;
+}
+
+void
+EventManager::registerComponent(MacroBaseComponent* comp)
+{
+  auto iter = migratable_components_.find(comp->componentId());
+  if (iter != migratable_components_.end()){
+    iter->second.push_back(comp);
+  }
+}
+
+void
+EventManager::selfLinks(uint32_t comp_id, std::vector<uint32_t>& links) const
+{
+  for (MacroBaseComponent* comp : migratable_components_.at(comp_id)){
+    links.push_back(comp->selfLinkId_);
+  }
+}
+
+void
+EventManager::migrateComponent(uint32_t comp_id, int thread, const std::vector<uint32_t>& links)
+{
+  EventManager* old_mgr = componentManager(comp_id);
+  EventManager* new_mgr = threadManager(thread);
+  if (old_mgr == new_mgr) return;
+
+  std::unordered_set<uint32_t> all_links(links.begin(), links.end());
+  setComponentManager(comp_id, thread);
+  for (MacroBaseComponent* comp : migratable_components_.at(comp_id)){
+    comp->setManager();
+    all_links.insert(comp->selfLinkId_);
+  }
+  old_mgr->migrateEvents(all_links, new_mgr);
+}
+
+void
+EventManager::migrateEvents(const std::unordered_set<uint32_t>& links, EventManager* dst)
+{
+  auto iter = event_queue_.begin();
+  while (iter != event_queue_.end()){
+    ExecutionEvent* ev = *iter;
+    if (links.find(ev->linkId()) != links.end()){
+      iter = event_queue_.erase(iter);
+      dst->schedule(ev);
+    } else {
+      ++iter;
+    }
+  }
+
+  //events sent by other threads this epoch that have not been registered yet
+  for (int slot=0; slot < num_pendingSlots; ++slot){
+    for (int thr=0; thr < nthread_; ++thr){
+      std::vector<ExecutionEvent*>& pending = pending_events_[slot][thr];
+      std::vector<ExecutionEvent*>& dst_pending = dst->pending_events_[slot][thr];
+      auto keep = pending.begin();
+      for (ExecutionEvent* ev : pending){
+        if (links.find(ev->linkId()) != links.end()){
+          dst_pending.push_back(ev);
+        } else {
+          *keep = ev;
+          ++keep;
+        }
+      }
+      pending.erase(keep, pending.end());
+    }
+  }
 }
 
 int
@@ -199,7 +342,16 @@ EventManager::runEvents(Timestamp event_horizon)
     } else {
       now_ = ev->time();
       event_queue_.erase(iter);
-      ev->execute();
+      if (profile_links_){
+        uint32_t linkId = ev->linkId();
+        uint64_t t_start = rdtsc();
+        ev->execute();
+        uint64_t cycles = rdtsc() - t_start;
+        linkCycleCounter(linkId) += cycles;
+        profiled_cycles_ += cycles;
+      } else {
+        ev->execute();
+      }
       delete ev;
     }
   }
@@ -222,20 +374,21 @@ EventManager::setInterconnect(hw::Interconnect* interconn)
 int
 EventManager::serializeSchedule(char* buf)
 {
-  serializer ser;
-  uint32_t bigSize = 1 << 30;
-  ser.start_unpacking(buf, bigSize); //just pass in a huge number
   IpcEvent iev;
-  ParallelRuntime::runSerialize(ser, &iev);
+  ParallelRuntime::unpackEvent(buf, &iev);
   scheduleIncoming(&iev);
-  size_t size = ser.unpacker().size();
-  align64(size);
-  return size;
+  return iev.ser_size;
 }
 
 void
 EventManager::registerStatisticCore(StatisticBase* base, SST::Params& params)
 {
+  if (global && global != this){
+    //thread managers share the groups of the main manager so each group is output once
+    global->registerStatisticCore(base, params);
+    return;
+  }
+
   StatisticGroup* grp = stat_groups_[base->groupName()];
   if (!grp){
     grp = new StatisticGroup(base->groupName());
@@ -421,7 +574,7 @@ EventManager::scheduleStop(Timestamp until)
   StopEvent* ev = new StopEvent(this);
   ev->setTime(until);
   ev->setSeqnum(0);
-  event_queue_.insert(ev);
+  schedule(ev);
 }
 
 Partition*
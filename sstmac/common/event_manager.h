@@ -72,6 +72,7 @@ Questions? Contact sst-macro-help@sandia.gov
 
 #include <vector>
 #include <queue>
+#include <unordered_set>
 #include <cstdint>
 #include <cstddef>
 
@@ -83,6 +84,13 @@ namespace sstmac {
 
 #if SSTMAC_INTEGRATED_SST_CORE
 #else
+static inline uint64_t rdtsc(void)
+{
+  uint32_t hi, lo;
+  __asm__ __volatile__ ("rdtsc" : "=a"(lo), "=d"(hi));
+  return uint64_t( (uint64_t)lo | (uint64_t)hi<<32);
+}
+
 /**
  * Base type for implementations of an engine that
  * is able to schedule events and advance simulation time
@@ -201,7 +209,7 @@ class EventManager
     return pendingSlot_;
   }
 
-  void schedule(ExecutionEvent* ev);
+  virtual void schedule(ExecutionEvent* ev);
 
   void setInterconnect(hw::Interconnect* ic);
 
@@ -216,7 +224,7 @@ class EventManager
    * @param event_horizon
    * @return Whether no more events or just hit event horizon
    */
-  Timestamp runEvents(Timestamp event_horizon);
+  virtual Timestamp runEvents(Timestamp event_horizon);
 
   Timestamp now() const {
     return now_;
@@ -232,7 +240,59 @@ class EventManager
     min_ipc_time_ = std::min(t,min_ipc_time_);
   }
 
-  Timestamp minEventTime() const {
+  /**
+   * @brief setMinThreadSendTime
+   * Record the arrival time of an event sent to another thread on this rank
+   * @param thread The destination thread
+   * @param t The arrival time
+   */
+  void setMinThreadSendTime(int thread, Timestamp t){
+    min_thread_send_time_[thread] = std::min(t, min_thread_send_time_[thread]);
+  }
+
+  /**
+   * @param thread The destination thread
+   * @return The earliest arrival of an event sent to the thread since the last clear
+   */
+  Timestamp minThreadSendTime(int thread) const {
+    return min_thread_send_time_[thread];
+  }
+
+  void clearMinThreadSendTimes();
+
+  /**
+   * @brief addThreadLinkLatency
+   * Record a link from this manager to a manager on another thread of the same rank
+   * @param thread The destination thread
+   * @param latency
+   */
+  void addThreadLinkLatency(int thread, TimeDelta latency);
+
+  /**
+   * @brief addRankLinkLatency
+   * Record a link from this manager to another rank
+   * @param rank The destination rank
+   * @param latency
+   */
+  void addRankLinkLatency(int rank, TimeDelta latency);
+
+  /**
+   * @param thread
+   * @return The minimum latency of any link from this manager to the thread, zero if none
+   */
+  TimeDelta minThreadLinkLatency(int thread) const {
+    return thread_link_latency_[thread];
+  }
+
+  /**
+   * @param rank
+   * @return The minimum latency of any link from this manager to the rank, zero if none
+   */
+  TimeDelta minRankLinkLatency(int rank) const {
+    return rank_link_latency_[rank];
+  }
+
+  virtual Timestamp minEventTime() const {
     return event_queue_.empty()
           ? no_events_left_time
           : (*event_queue_.begin())->time();
@@ -249,6 +309,63 @@ class EventManager
 
   void addLinkHandler(uint64_t linkId, EventHandler* handler);
 
+  /**
+   * @brief setProfileLinks
+   * Turn on or off accumulating the cycles spent executing the events of each link
+   * @param flag
+   */
+  void setProfileLinks(bool flag){
+    profile_links_ = flag;
+  }
+
+  /**
+   * @brief linkCycles
+   * @param linkId
+   * @return The cycles spent executing events on the link since the last clear
+   */
+  uint64_t linkCycles(uint32_t linkId) const;
+
+  /**
+   * @return The cycles spent executing events on all links since the last clear
+   */
+  uint64_t profiledCycles() const {
+    return profiled_cycles_;
+  }
+
+  void clearLinkCycles();
+
+  bool allowMigration() const {
+    return allow_migration_;
+  }
+
+  /**
+   * @brief addMigratableComponent
+   * Track all objects created for the component so they can later be moved to a new thread
+   * @param comp_id
+   */
+  void addMigratableComponent(uint32_t comp_id){
+    migratable_components_[comp_id];
+  }
+
+  void registerComponent(MacroBaseComponent* comp);
+
+  /**
+   * @brief selfLinks
+   * @param comp_id A migratable component
+   * @param links [out] The self link IDs used by the component and its subcomponents
+   */
+  void selfLinks(uint32_t comp_id, std::vector<uint32_t>& links) const;
+
+  /**
+   * @brief migrateComponent
+   * Move a component and all its pending events to a new thread manager.
+   * Must only be called between epochs while no worker is running events.
+   * @param comp_id A migratable component
+   * @param thread The new thread
+   * @param links The links delivering events to the component, excluding its self links
+   */
+  void migrateComponent(uint32_t comp_id, int thread, const std::vector<uint32_t>& links);
+
  protected:
   void registerPending();
 
@@ -256,6 +373,20 @@ class EventManager
     return vote;
   }
 
+  /**
+   * @brief clearEvents
+   * Delete all pending events, e.g. when the simulation is stopped early
+   */
+  virtual void clearEvents();
+
+  /**
+   * @brief migrateEvents
+   * Move all pending events on the given links to another manager
+   * @param links
+   * @param dst
+   */
+  void migrateEvents(const std::unordered_set<uint32_t>& links, EventManager* dst);
+
 #define num_pendingSlots 4
   int pendingSlot_;
   std::vector<std::vector<ExecutionEvent*>> pending_events_[num_pendingSlots];
@@ -270,6 +401,7 @@ class EventManager
   sw::ThreadContext* main_thread_;
   bool scheduled_;
   bool stopped_;
+  bool allow_migration_;
 
   int me_;
   int nproc_;
@@ -319,6 +451,26 @@ class EventManager
 
   std::unordered_map<uint32_t,int> component_to_thread_;
 
+ private:
+  uint64_t& linkCycleCounter(uint32_t linkId);
+
+  bool profile_links_;
+  uint64_t profiled_cycles_;
+
+  /** Cycles for interconnect links, which are numbered up from zero */
+  std::vector<uint64_t> link_cycles_;
+
+  /** Cycles for self links, which are numbered down from the top of the id space */
+  std::vector<uint64_t> self_link_cycles_;
+
+  std::unordered_map<uint32_t,std::vector<MacroBaseComponent*>> migratable_components_;
+
+  std::vector<Timestamp> min_thread_send_time_;
+
+  std::vector<TimeDelta> thread_link_latency_;
+
+  std::vector<TimeDelta> rank_link_latency_;
+
 };
 
 class NullEventManager : public EventManager
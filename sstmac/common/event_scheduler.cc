@@ -51,6 +51,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/hardware/node/node.h>
 #include <sstmac/common/ipc_event.h>
 #include <sstmac/common/handler_event_queue_entry.h>
+#include <sstmac/common/thread_lock.h>
 #include <sprockit/sim_parameters.h>
 #include <sprockit/util.h>
 #include <sprockit/output.h>
@@ -181,9 +182,48 @@ MacroBaseComponent::setManager()
   now_ = mgr_->nowPtr();
 }
 
+void
+MacroBaseComponent::initManager()
+{
+  setManager();
+  EventManager::global->registerComponent(this);
+}
+
 TimeDelta EventLink::minRemoteLatency_;
 TimeDelta EventLink::minThreadLatency_;
 uint32_t EventLink::selfLinkIdCounter_{0};
+
+static thread_lock min_latency_lock;
+
+void
+EventLink::setMinThreadLatency(TimeDelta t)
+{
+  if (t.ticks() == 0){
+    spkt_abort_printf("setting link latency to zero across threads!");
+  }
+  min_latency_lock.lock();
+  if (minThreadLatency_.ticks() == 0){
+    minThreadLatency_ = t;
+  } else {
+    minThreadLatency_ = std::min(minThreadLatency_, t);
+  }
+  min_latency_lock.unlock();
+}
+
+void
+EventLink::setMinRemoteLatency(TimeDelta t)
+{
+  if (t.ticks() == 0){
+    spkt_abort_printf("setting link latency to zero across threads!");
+  }
+  min_latency_lock.lock();
+  if (minRemoteLatency_.ticks() == 0){
+    minRemoteLatency_ = t;
+  } else {
+    minRemoteLatency_ = std::min(minRemoteLatency_, t);
+  }
+  min_latency_lock.unlock();
+}
 #endif
 
 void
@@ -230,6 +270,20 @@ LocalLink::send(TimeDelta delay, Event *ev)
   mgr_->schedule(qev);
 }
 
+IpcLink::IpcLink(uint64_t linkId, TimeDelta latency,
+                 int rank, int thread,
+                 EventManager* src_mgr,
+                 EventManager* ipc_mgr) :
+  EventLink(linkId, latency),
+  rank_(rank),
+  thread_(thread),
+  ev_mgr_(src_mgr),
+  ipc_mgr_(ipc_mgr)
+{
+  setMinRemoteLatency(latency);
+  src_mgr->addRankLinkLatency(rank, latency);
+}
+
 void
 IpcLink::send(TimeDelta delay, Event *ev)
 {
@@ -255,16 +309,31 @@ IpcLink::deliver(Event* /*ev*/){
   spkt_abort_printf("IpcLink: cannot direct deliver events");
 }
 
+MultithreadLink::MultithreadLink(uint64_t linkId, TimeDelta latency,
+                                 EventManager* src_mgr, EventManager* dst_mgr,
+                                 EventHandler* handler) :
+  LocalLink(linkId, latency, src_mgr, handler),
+  dst_mgr_(dst_mgr)
+{
+  setMinThreadLatency(latency);
+  src_mgr->addThreadLinkLatency(dst_mgr->thread(), latency);
+}
+
 void
 MultithreadLink::send(TimeDelta delay, Event* ev)
 {
   ExecutionEvent* qev = new HandlerExecutionEvent(ev, handler_);
   Timestamp arrival = mgr_->now() + delay + latency_;
-  mgr_->setMinIpcTime(arrival);
   qev->setTime(arrival);
   qev->setSeqnum(seqnum_++);
   qev->setLink(linkId_);
-  dst_mgr_->multithreadSchedule(mgr_->pendingSlot(), mgr_->thread(), qev);
+  if (dst_mgr_ == mgr_){
+    //both ends are on the same thread after a component migrated
+    mgr_->schedule(qev);
+  } else {
+    mgr_->setMinThreadSendTime(dst_mgr_->thread(), arrival);
+    dst_mgr_->multithreadSchedule(mgr_->pendingSlot(), mgr_->thread(), qev);
+  }
 }
 
 void
@@ -148,27 +148,10 @@ class EventLink {
   {
   }
 
-  static void setMinThreadLatency(TimeDelta t){
-    if (t.ticks() == 0){
-      spkt_abort_printf("setting link latency to zero across threads!");
-    }
-    if (minThreadLatency_.ticks() == 0){
-      minThreadLatency_ = t;
-    } else {
-      minThreadLatency_ = std::min(minThreadLatency_, t);
-    }
-  }
+  /** Links can be built concurrently by several threads, so these lock */
+  static void setMinThreadLatency(TimeDelta t);
 
-  static void setMinRemoteLatency(TimeDelta t){
-    if (t.ticks() == 0){
-      spkt_abort_printf("setting link latency to zero across threads!");
-    }
-    if (minRemoteLatency_.ticks() == 0){
-      minRemoteLatency_ = t;
-    } else {
-      minRemoteLatency_ = std::min(minRemoteLatency_, t);
-    }
-  }
+  static void setMinRemoteLatency(TimeDelta t);
 
   uint32_t seqnum_;
   uint64_t linkId_;
@@ -471,7 +454,7 @@ class MacroBaseComponent
     thread_id_(0),
     nthread_(1)
   {
-    setManager();
+    initManager();
   }
 
   MacroBaseComponent(uint32_t id)
@@ -482,8 +465,12 @@ class MacroBaseComponent
   EventLink::ptr allocateSubLink(const std::string& /*name*/, TimeDelta lat, LinkHandler* handler);
 
  private:
+  friend class EventManager;
+
   void registerStatisticCore(StatisticBase* base, SST::Params& params);
 
+  void initManager();
+
   EventManager* mgr_;
   uint32_t seqnum_;
   uint32_t selfLinkId_;
@@ -583,17 +570,30 @@ class MultithreadLink : public LocalLink {
  public:
   MultithreadLink(uint64_t linkId, TimeDelta latency,
                   EventManager* src_mgr, EventManager* dst_mgr,
-                  EventHandler* handler) :
-    LocalLink(linkId, latency, src_mgr, handler),
-    dst_mgr_(dst_mgr)
-  {
-    setMinThreadLatency(latency);
-  }
+                  EventHandler* handler);
 
   void deliver(Event* ev) override;
 
   void send(TimeDelta delay, Event *ev) override;
 
+  /**
+   * @brief setSrcManager
+   * Used when the sending component migrates to another thread
+   * @param mgr
+   */
+  void setSrcManager(EventManager* mgr){
+    mgr_ = mgr;
+  }
+
+  /**
+   * @brief setDstManager
+   * Used when the receiving component migrates to another thread
+   * @param mgr
+   */
+  void setDstManager(EventManager* mgr){
+    dst_mgr_ = mgr;
+  }
+
  private:
   EventManager* dst_mgr_;
 
@@ -605,15 +605,7 @@ class IpcLink : public EventLink {
          TimeDelta latency,
          int rank, int thread,
          EventManager* src_mgr,
-         EventManager* ipc_mgr) :
-    EventLink(linkId, latency),
-    rank_(rank),
-    thread_(thread),
-    ev_mgr_(src_mgr),
-    ipc_mgr_(ipc_mgr)
-  {
-    setMinRemoteLatency(latency);
-  }
+         EventManager* ipc_mgr);
 
   std::string toString() const override {
     return "ipc link";
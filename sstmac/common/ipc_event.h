@@ -50,19 +50,68 @@ Questions? Contact sst-macro-help@sandia.gov
 
 namespace sstmac {
 
+/**
+ * @brief The IpcEventBase struct
+ * The fixed header preceding every event sent between ranks.
+ * The size and thread must come first so that a receiver can route
+ * the event to a thread before unpacking it.
+ */
 struct IpcEventBase {
   uint32_t ser_size;
+  uint32_t thread;
   Timestamp t;
   uint64_t link;
   uint32_t seqnum;
   uint32_t rank;
-  uint32_t thread;
+  uint32_t wire_type;
 };
 
 struct IpcEvent : public IpcEventBase {
   Event* ev;
 };
 
+/**
+ * @brief The IpcWire class
+ * The hot event types crossing ranks are packed as fixed-layout structs
+ * instead of going through the serializer. The wire type in the IPC header
+ * selects the function that rebuilds the event on the receiving rank.
+ * All other events use the Serialized type.
+ */
+class IpcWire
+{
+ public:
+  enum Type : uint32_t {
+    Serialized=0,
+    SnapprPacket,
+    SnapprCredit,
+    PiscesPacket,
+    PiscesCredit,
+    NicEvent,
+    NumTypes
+  };
+
+  typedef Event* (*unpack_fxn)(const char* buf);
+
+  struct Registration {
+    Registration(Type type, unpack_fxn fxn){
+      registerType(type, fxn);
+    }
+  };
+
+  static void registerType(Type type, unpack_fxn fxn);
+
+  /**
+   * @brief unpack
+   * @param type The wire type from the IPC header
+   * @param buf The packed event following the IPC header
+   * @return A newly allocated event
+   */
+  static Event* unpack(uint32_t type, const char* buf);
+
+ private:
+  static unpack_fxn* unpackers();
+};
+
 }
 
 #endif
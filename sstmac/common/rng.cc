@@ -174,6 +174,57 @@ MWC::nseed()
   return 2;
 }
 
+////////////////////////////////////////////////////////////////////
+// Philox
+
+Philox::Philox() :
+  counter_(0), next_(4)
+{
+}
+
+Philox*
+Philox::construct()
+{
+  Philox* result(new Philox);
+  result->reseed();
+  return result;
+}
+
+Philox*
+Philox::construct(const std::vector<rngint_t> &seeds)
+{
+  Philox* result(new Philox);
+  result->vec_reseed(seeds);
+  return result;
+}
+
+Philox*
+Philox::construct(rngint_t k0, rngint_t k1)
+{
+  Philox* result(new Philox);
+  result->reseed(k0, k1);
+  return result;
+}
+
+Philox::~Philox()
+{
+}
+
+void
+Philox::vec_reseed(const std::vector<rngint_t> &seeds)
+{
+  key_[0] = seeds.size() > 0 ? seeds[0] : defaultz;
+  key_[1] = seeds.size() > 1 ? seeds[1] : defaultw;
+  counter_ = 0;
+  next_ = 4;
+}
+
+int
+Philox::nseed()
+{
+  return 2;
+}
+
 ////////////////////////////////////////////////////////////////////
 // SHR3
 
@@ -516,6 +516,88 @@ class Combo : public UniformInteger
 
 };
 
+/** The Philox4x32-10 counter-based random number generator of
+ Salmon, Moraes, Dror and Shaw (SC 2011).
+
+ A draw is a pure function of a 64-bit key and a 128-bit counter, so
+ callers can key a stream on, e.g., a switch id and derive each value from
+ a flow id and an attempt number without ever reseeding. The same
+ (key, counter) always gives the same value regardless of which thread or
+ rank asks for it. Used through the UniformInteger interface, the counter
+ simply increments with every block of four values.
+ */
+class Philox : public UniformInteger
+{
+ public:
+  static Philox* construct();
+
+  static Philox* construct(const std::vector<rngint_t>& seeds);
+
+  static Philox* construct(rngint_t k0, rngint_t k1);
+
+  ~Philox() override;
+
+  /**
+   * @brief block Compute the four 32-bit outputs for a counter
+   * @param key The 64-bit key as two words
+   * @param ctr The 128-bit counter as four words
+   * @param out The four random outputs
+   */
+  static void block(const rngint_t key[2], const rngint_t ctr[4], rngint_t out[4]){
+    rngint_t k0 = key[0], k1 = key[1];
+    rngint_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+    for (int r=0; r < 10; ++r){
+      uint64_t p0 = uint64_t(0xD2511F53) * c0;
+      uint64_t p1 = uint64_t(0xCD9E8D57) * c2;
+      rngint_t hi0 = p0 >> 32, lo0 = rngint_t(p0);
+      rngint_t hi1 = p1 >> 32, lo1 = rngint_t(p1);
+      c0 = hi1 ^ c1 ^ k0;
+      c1 = lo1;
+      c2 = hi0 ^ c3 ^ k1;
+      c3 = lo0;
+      k0 += 0x9E3779B9;
+      k1 += 0xBB67AE85;
+    }
+    out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+  }
+
+  /**
+   * @brief draw A single stateless value for a (key, counter) pair
+   * @return The first output of the Philox block
+   */
+  static rngint_t draw(rngint_t k0, rngint_t k1,
+                       rngint_t c0, rngint_t c1, rngint_t c2 = 0, rngint_t c3 = 0){
+    rngint_t key[2] = {k0, k1};
+    rngint_t ctr[4] = {c0, c1, c2, c3};
+    rngint_t out[4];
+    block(key, ctr, out);
+    return out[0];
+  }
+
+  rngint_t value() override {
+    if (next_ == 4){
+      rngint_t ctr[4] = {rngint_t(counter_), rngint_t(counter_ >> 32), 0, 0};
+      block(key_, ctr, buffer_);
+      ++counter_;
+      next_ = 0;
+    }
+    return buffer_[next_++];
+  }
+
+  void vec_reseed(const std::vector<rngint_t> &seeds) override;
+
+  int nseed() override;
+
+ protected:
+  Philox();
+
+ private:
+  rngint_t key_[2];
+  rngint_t buffer_[4];
+  uint64_t counter_;
+  int next_;
+};
+
 /** Converts a shared* to a RNG to a functor. */
 class UniformInteger_functor
 {
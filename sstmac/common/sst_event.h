@@ -64,6 +64,28 @@ class Event : public serializable
 {
  public:
   void serialize_order(serializer&) override{}
+
+  /**
+   * @brief ipcWireType
+   * @return The IpcWire type of a fixed-layout format for sending this event
+   *         between ranks, or IpcWire::Serialized to use the serializer
+   */
+  virtual uint32_t ipcWireType() const {
+    return 0;
+  }
+
+  /**
+   * @return The number of bytes written by packWire
+   */
+  virtual size_t ipcWireSize() const {
+    return 0;
+  }
+
+  /**
+   * @brief packWire Write this event in its fixed-layout wire format
+   * @param buf A buffer of at least ipcWireSize() bytes, aligned to 8 bytes
+   */
+  virtual void packWire(char*  /*buf*/) const {}
 };
 #endif
 
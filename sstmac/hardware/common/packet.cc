@@ -84,6 +84,58 @@ Packet::serialize_order(serializer& ser)
   ser & nic_metadata_;
   ser & qos_;
 }
+#if !SSTMAC_INTEGRATED_SST_CORE
+uint32_t
+Packet::payloadWireSize() const
+{
+  if (!payload_) return 0;
+
+  Flow* payload = payload_;
+  serializer ser;
+  ser.start_sizing();
+  ser & payload;
+  return ser.size();
+}
+
+void
+Packet::packWireFields(WireFields& fields, char* payload_buf, uint32_t payload_bytes) const
+{
+  fields.flow_id = flow_id_;
+  fields.num_bytes = num_bytes_;
+  fields.toaddr = toaddr_;
+  fields.fromaddr = fromaddr_;
+  fields.qos = qos_;
+  fields.payload_bytes = payload_bytes;
+  ::memcpy(fields.rtr_metadata, rtr_metadata_, sizeof(rtr_metadata_));
+  ::memcpy(fields.nic_metadata, nic_metadata_, sizeof(nic_metadata_));
+  ::memcpy(fields.stats_metadata, stats_metadata_, sizeof(stats_metadata_));
+  if (payload_bytes){
+    Flow* payload = payload_;
+    serializer ser;
+    ser.start_packing(payload_buf, payload_bytes);
+    ser & payload;
+  }
+}
+
+void
+Packet::unpackWireFields(const WireFields& fields, const char* payload_buf)
+{
+  flow_id_ = fields.flow_id;
+  num_bytes_ = fields.num_bytes;
+  toaddr_ = fields.toaddr;
+  fromaddr_ = fields.fromaddr;
+  qos_ = fields.qos;
+  ::memcpy(rtr_metadata_, fields.rtr_metadata, sizeof(rtr_metadata_));
+  ::memcpy(nic_metadata_, fields.nic_metadata, sizeof(nic_metadata_));
+  ::memcpy(stats_metadata_, fields.stats_metadata, sizeof(stats_metadata_));
+  payload_ = nullptr;
+  if (fields.payload_bytes){
+    serializer ser;
+    ser.start_unpacking(const_cast<char*>(payload_buf), fields.payload_bytes);
+    ser & payload_;
+  }
+}
+#endif
 
 }
 }
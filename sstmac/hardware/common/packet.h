@@ -149,6 +149,41 @@ class Packet :
     return qos_;
   }
 
+#if !SSTMAC_INTEGRATED_SST_CORE
+ protected:
+  /**
+   * @brief The WireFields struct
+   * The fixed-layout part of a packet crossing ranks.
+   * A flow payload, if any, is serialized after the derived packet's fields.
+   */
+  struct WireFields {
+    uint64_t flow_id;
+    uint32_t num_bytes;
+    NodeId toaddr;
+    NodeId fromaddr;
+    int32_t qos;
+    uint32_t payload_bytes;
+    char rtr_metadata[MAX_HEADER_BYTES];
+    char nic_metadata[MAX_NIC_BYTES];
+    char stats_metadata[MAX_STAT_BYTES];
+  };
+
+  /**
+   * @return The number of bytes needed to serialize the payload, zero if none
+   */
+  uint32_t payloadWireSize() const;
+
+  /**
+   * @brief packWireFields
+   * @param fields [out] The packet fields
+   * @param payload_buf Where to serialize the payload, if any
+   * @param payload_bytes The payload size from payloadWireSize
+   */
+  void packWireFields(WireFields& fields, char* payload_buf, uint32_t payload_bytes) const;
+
+  void unpackWireFields(const WireFields& fields, const char* payload_buf);
+#endif
+
  private:
   NodeId toaddr_;
 
@@ -0,0 +1,330 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif
+
+#include <inttypes.h>
+
+#include <sstmac/hardware/fluid/fluid.h>
+#include <sstmac/hardware/network/network_message.h>
+#include <sstmac/common/event_manager.h>
+#include <sprockit/errors.h>
+#include <sprockit/util.h>
+
+#include <algorithm>
+#include <limits>
+#include <queue>
+
+RegisterDebugSlot(fluid, "print all the details of the fluid flow model")
+
+namespace sstmac {
+namespace hw {
+
+FluidPacket::FluidPacket(NetworkMessage* msg, NodeId toaddr, NodeId fromaddr) :
+  Packet(msg, uint32_t(std::min(msg->byteLength(), uint64_t(std::numeric_limits<uint32_t>::max()))),
+         msg->flowId(), true, fromaddr, toaddr)
+{
+}
+
+std::string
+FluidPacket::toString() const
+{
+  return sprockit::sprintf("fluid head flow %" PRIu64 " after %d hops: %s",
+                          flowId(), int(links_.size()), flow()
+                          ? flow()->toString().c_str()
+                          : "no payload");
+}
+
+void
+FluidPacket::serialize_order(serializer& ser)
+{
+  Packet::serialize_order(ser);
+  ser & links_;
+  ser & bandwidths_;
+}
+
+FluidNetwork::FluidNetwork() :
+  next_flow_id_(0),
+  visit_(0),
+  wakeup_pending_(false)
+{
+}
+
+FluidNetwork*
+FluidNetwork::get()
+{
+#if !SSTMAC_INTEGRATED_SST_CORE
+  if (EventManager::global->nproc() > 1 || EventManager::global->nthread() > 1){
+    spkt_abort_printf("fluid network model shares bandwidth globally and only supports serial runs");
+  }
+#endif
+  static FluidNetwork net;
+  return &net;
+}
+
+void
+FluidNetwork::registerNIC(NodeId nid, FluidNIC* nic)
+{
+  nics_[nid] = nic;
+}
+
+FluidNIC*
+FluidNetwork::nic(NodeId nid) const
+{
+  auto iter = nics_.find(nid);
+  if (iter == nics_.end()){
+    spkt_abort_printf("fluid network has no NIC for node %d", int(nid));
+  }
+  return iter->second;
+}
+
+FluidNetwork::Link*
+FluidNetwork::getLink(uint64_t id, double bw)
+{
+  auto iter = links_.find(id);
+  if (iter == links_.end()){
+    Link& l = links_[id];
+    l.id = id;
+    l.bandwidth = bw;
+    l.capacity_left = bw;
+    l.num_unfrozen = 0;
+    l.version = 0;
+    l.visit = 0;
+    return &l;
+  }
+  return &iter->second;
+}
+
+int
+FluidNetwork::numFlows(uint64_t link) const
+{
+  auto iter = links_.find(link);
+  return iter == links_.end() ? 0 : iter->second.flows.size();
+}
+
+void
+FluidNetwork::start(FluidPacket* head, Timestamp now)
+{
+  ActiveFlow* f = new ActiveFlow;
+  f->id = next_flow_id_++;
+  f->msg = static_cast<NetworkMessage*>(head->flow());
+  f->remaining = f->msg->byteLength();
+  f->rate = 0;
+  f->last_update = now;
+  f->visit = 0;
+  f->frozen = false;
+  auto& ids = head->links();
+  auto& bws = head->bandwidths();
+  for (int i=0; i < ids.size(); ++i){
+    Link* l = getLink(ids[i], bws[i]);
+    if (std::find(f->path.begin(), f->path.end(), l) != f->path.end()){
+      continue; //a link only limits a flow once
+    }
+    f->path.push_back(l);
+    l->flows.push_back(f);
+    dirty_.push_back(l);
+  }
+  active_[f->id] = f;
+  debug_printf(sprockit::dbg::fluid, "starting flow %" PRIu64 " of %" PRIu64 " bytes over %d links: %s",
+               f->id, f->msg->byteLength(), int(f->path.size()), f->msg->toString().c_str());
+}
+
+void
+FluidNetwork::advance(Timestamp now, std::vector<NetworkMessage*>& done)
+{
+  while (!finish_order_.empty() && finish_order_.begin()->first <= now){
+    uint64_t id = finish_order_.begin()->second;
+    finish_order_.erase(finish_order_.begin());
+    auto iter = active_.find(id);
+    ActiveFlow* f = iter->second;
+    active_.erase(iter);
+    for (Link* l : f->path){
+      l->flows.erase(std::find(l->flows.begin(), l->flows.end(), f));
+      dirty_.push_back(l);
+    }
+    debug_printf(sprockit::dbg::fluid, "finished flow %" PRIu64 " at t=%10.6e: %s",
+                 f->id, now.sec(), f->msg->toString().c_str());
+    done.push_back(f->msg);
+    delete f;
+  }
+}
+
+void
+FluidNetwork::wakeupFired(Timestamp now)
+{
+  if (wakeup_pending_ && now >= next_wakeup_){
+    wakeup_pending_ = false;
+  }
+}
+
+bool
+FluidNetwork::settle(Timestamp now, Timestamp& wakeup)
+{
+  if (!dirty_.empty()){
+    //only flows connected to a changed link through shared links can change rate
+    ++visit_;
+    std::vector<Link*> links;
+    std::vector<ActiveFlow*> flows;
+    for (Link* l : dirty_){
+      if (l->visit != visit_){
+        l->visit = visit_;
+        links.push_back(l);
+      }
+    }
+    dirty_.clear();
+    for (int i=0; i < links.size(); ++i){
+      for (ActiveFlow* f : links[i]->flows){
+        if (f->visit == visit_) continue;
+        f->visit = visit_;
+        flows.push_back(f);
+        for (Link* l : f->path){
+          if (l->visit != visit_){
+            l->visit = visit_;
+            links.push_back(l);
+          }
+        }
+      }
+    }
+
+    std::vector<double> old_rates(flows.size());
+    for (int i=0; i < flows.size(); ++i){
+      ActiveFlow* f = flows[i];
+      old_rates[i] = f->rate;
+      if (f->rate > 0){
+        f->remaining = std::max(0., f->remaining - f->rate * (now - f->last_update).sec());
+      }
+      f->last_update = now;
+    }
+
+    fill(flows, links);
+
+    for (int i=0; i < flows.size(); ++i){
+      ActiveFlow* f = flows[i];
+      if (f->rate == old_rates[i]) continue; //still finishes at the same time
+      if (old_rates[i] > 0){
+        finish_order_.erase(std::make_pair(f->finish, f->id));
+      }
+      f->finish = now + TimeDelta(f->remaining / f->rate);
+      finish_order_.emplace(f->finish, f->id);
+    }
+    debug_printf(sprockit::dbg::fluid, "recomputed %d flows over %d links at t=%10.6e",
+                 int(flows.size()), int(links.size()), now.sec());
+  }
+
+  if (finish_order_.empty()) return false;
+
+  wakeup = finish_order_.begin()->first;
+  return requestWakeup(wakeup);
+}
+
+bool
+FluidNetwork::requestWakeup(Timestamp t)
+{
+  if (!wakeup_pending_ || t < next_wakeup_){
+    wakeup_pending_ = true;
+    next_wakeup_ = t;
+    return true;
+  }
+  return false;
+}
+
+void
+FluidNetwork::fill(std::vector<ActiveFlow*>& flows, std::vector<Link*>& links)
+{
+  struct Share {
+    double share;
+    uint64_t link_id;
+    uint32_t version;
+    Link* link;
+    bool operator>(const Share& r) const {
+      if (share == r.share) return link_id > r.link_id;
+      return share > r.share;
+    }
+  };
+  //progressive filling: the most constrained link fixes the rate of all its flows.
+  //shares never decrease as flows are frozen, so stale heap entries can be skipped
+  std::priority_queue<Share, std::vector<Share>, std::greater<Share>> queue;
+  for (Link* l : links){
+    l->capacity_left = l->bandwidth;
+    l->num_unfrozen = l->flows.size();
+    l->version = 0;
+    if (l->num_unfrozen > 0){
+      queue.push({l->capacity_left / l->num_unfrozen, l->id, l->version, l});
+    }
+  }
+  for (ActiveFlow* f : flows){
+    f->frozen = false;
+  }
+
+  double last_share = 0;
+  while (!queue.empty()){
+    Share next = queue.top();
+    queue.pop();
+    Link* l = next.link;
+    if (next.version != l->version || l->num_unfrozen == 0) continue;
+
+    //guard against round-off making a share smaller than the previous one
+    double share = std::max(last_share, l->capacity_left / l->num_unfrozen);
+    last_share = share;
+    for (ActiveFlow* f : l->flows){
+      if (f->frozen) continue;
+      f->frozen = true;
+      f->rate = share;
+      for (Link* fl : f->path){
+        fl->capacity_left -= share;
+        fl->num_unfrozen--;
+        if (fl != l && fl->num_unfrozen > 0){
+          fl->version++;
+          queue.push({fl->capacity_left / fl->num_unfrozen, fl->id, fl->version, fl});
+        }
+      }
+    }
+  }
+}
+
+}
+}
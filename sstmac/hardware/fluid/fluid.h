@@ -0,0 +1,228 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+
+#ifndef fluid_packet_h
+#define fluid_packet_h
+
+#include <sstmac/hardware/common/packet.h>
+#include <sstmac/hardware/common/flow.h>
+#include <sstmac/hardware/network/network_message_fwd.h>
+#include <sstmac/common/timestamp.h>
+#include <sprockit/thread_safe_new.h>
+#include <sprockit/debug.h>
+
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+DeclareDebugSlot(fluid)
+
+namespace sstmac {
+namespace hw {
+
+class FluidNIC;
+
+/**
+ @class FluidPacket
+ The head of a message in the fluid model. It is routed hop-by-hop
+ like any other packet, recording each link it crosses. Once it reaches
+ the destination NIC, the recorded path carries the whole message as a fluid flow.
+ */
+class FluidPacket :
+  public Packet,
+  public sprockit::thread_safe_new<FluidPacket>
+{
+  ImplementSerializable(FluidPacket)
+
+ public:
+  FluidPacket(NetworkMessage* msg, NodeId toaddr, NodeId fromaddr);
+
+  FluidPacket(){} //for serialization
+
+  std::string toString() const override;
+
+  ~FluidPacket() override {}
+
+  int nextPort() const {
+    return rtrHeader<Header>()->edge_port;
+  }
+
+  /**
+   * @brief addHop
+   * @param link A globally unique id for the link
+   * @param bw The bandwidth of the link in B/s
+   */
+  void addHop(uint64_t link, double bw){
+    links_.push_back(link);
+    bandwidths_.push_back(bw);
+  }
+
+  const std::vector<uint64_t>& links() const {
+    return links_;
+  }
+
+  const std::vector<double>& bandwidths() const {
+    return bandwidths_;
+  }
+
+  void serialize_order(serializer& ser) override;
+
+ private:
+  std::vector<uint64_t> links_;
+  std::vector<double> bandwidths_;
+};
+
+/**
+ @class FluidNetwork
+ Shares link bandwidth between all active flows by max-min fairness.
+ Rates only change when a flow starts or finishes, and only flows connected
+ to the changed flow through shared links are recomputed.
+ Because rates depend on every flow in the network, a single instance
+ is shared by all fluid components, which restricts the model to serial runs.
+ */
+class FluidNetwork
+{
+ public:
+  struct Link;
+
+  struct ActiveFlow {
+    uint64_t id;
+    NetworkMessage* msg;
+    std::vector<Link*> path;
+    double remaining; //bytes
+    double rate; //B/s
+    Timestamp last_update;
+    Timestamp finish;
+    uint64_t visit;
+    bool frozen;
+  };
+
+  struct Link {
+    uint64_t id;
+    double bandwidth;
+    double capacity_left;
+    int num_unfrozen;
+    uint32_t version;
+    uint64_t visit;
+    std::vector<ActiveFlow*> flows; //ordered by flow id
+  };
+
+  static FluidNetwork* get();
+
+  static uint64_t switchLinkId(SwitchId sid, int port){
+    return (uint64_t(sid) << 32) | uint32_t(port);
+  }
+
+  static uint64_t injectionLinkId(NodeId nid){
+    return (uint64_t(1) << 63) | uint64_t(nid);
+  }
+
+  void registerNIC(NodeId nid, FluidNIC* nic);
+
+  FluidNIC* nic(NodeId nid) const;
+
+  /**
+   * @brief start Begin moving a message along the path recorded by its head
+   * @param head The head packet, which is not deleted
+   * @param now
+   */
+  void start(FluidPacket* head, Timestamp now);
+
+  /**
+   * @brief advance Finish all flows whose last byte arrives no later than now
+   * @param now
+   * @param done [out] The messages that completed
+   */
+  void advance(Timestamp now, std::vector<NetworkMessage*>& done);
+
+  /**
+   * @brief settle Recompute the rates of all flows affected by starts/finishes
+   *        since the last call and decide whether a new wakeup is needed
+   * @param now
+   * @param wakeup [out] The time to schedule a wakeup
+   * @return Whether a wakeup must be scheduled
+   */
+  bool settle(Timestamp now, Timestamp& wakeup);
+
+  /**
+   * @brief requestWakeup
+   * @param t The time a wakeup is needed
+   * @return Whether a new wakeup must be scheduled, false if one is already pending no later than t
+   */
+  bool requestWakeup(Timestamp t);
+
+  /**
+   * @brief wakeupFired Notify that a scheduled wakeup has run
+   * @param now
+   */
+  void wakeupFired(Timestamp now);
+
+  /**
+   * @return The number of flows currently crossing the link
+   */
+  int numFlows(uint64_t link) const;
+
+ private:
+  FluidNetwork();
+
+  Link* getLink(uint64_t id, double bw);
+
+  void fill(std::vector<ActiveFlow*>& flows, std::vector<Link*>& links);
+
+  std::unordered_map<uint64_t, Link> links_;
+  std::unordered_map<NodeId, FluidNIC*> nics_;
+  std::set<std::pair<Timestamp,uint64_t>> finish_order_;
+  std::unordered_map<uint64_t, ActiveFlow*> active_;
+  std::vector<Link*> dirty_;
+  uint64_t next_flow_id_;
+  uint64_t visit_;
+  Timestamp next_wakeup_;
+  bool wakeup_pending_;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,157 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+
+#include <sstmac/hardware/network/network_message.h>
+#include <sstmac/hardware/fluid/fluid_nic.h>
+#include <sstmac/common/event_callback.h>
+#include <sprockit/errors.h>
+#include <sprockit/util.h>
+#include <sprockit/sim_parameters.h>
+
+namespace sstmac {
+namespace hw {
+
+FluidNIC::FluidNIC(uint32_t id, SST::Params& params, Node* parent) :
+  NIC(id, params, parent),
+  net_(FluidNetwork::get())
+{
+  SST::Params inj_params = params.find_scoped_params("injection");
+  inj_bw_ = inj_params.find<SST::UnitAlgebra>("bandwidth").getValue().toDouble();
+  net_->registerNIC(addr(), this);
+}
+
+FluidNIC::~FluidNIC() throw ()
+{
+}
+
+LinkHandler*
+FluidNIC::payloadHandler(int port)
+{
+  if (port == NIC::LogP){
+    return newLinkHandler(this, &NIC::mtlHandle);
+  } else {
+    return newLinkHandler(this, &FluidNIC::handlePayload);
+  }
+}
+
+LinkHandler*
+FluidNIC::creditHandler(int  /*port*/)
+{
+  return newLinkHandler(this, &FluidNIC::handleCredit);
+}
+
+void
+FluidNIC::connectOutput(int src_outport, int  /*dst_inport*/, EventLink::ptr&& link)
+{
+  if (src_outport == Injection){
+    inj_link_ = std::move(link);
+  } else if (src_outport == LogP) {
+    logp_link_ = std::move(link);
+  } else {
+    spkt_abort_printf("Invalid switch port %d in FluidNIC::connectOutput", src_outport);
+  }
+}
+
+void
+FluidNIC::connectInput(int /*src_outport*/, int /*dst_inport*/,
+                       EventLink::ptr&& /*link*/)
+{
+  //nothing to do
+}
+
+void
+FluidNIC::doSend(NetworkMessage* payload)
+{
+  nic_debug("fluid: sending %s", payload->toString().c_str());
+  FluidPacket* head = new FluidPacket(payload, payload->toaddr(), payload->fromaddr());
+  head->addHop(FluidNetwork::injectionLinkId(addr()), inj_bw_);
+  inj_link_->send(head);
+}
+
+void
+FluidNIC::handlePayload(Event *ev)
+{
+  FluidPacket* head = static_cast<FluidPacket*>(ev);
+  net_->start(head, now());
+  delete head;
+  //heads arriving at the same time share a single recompute
+  if (net_->requestWakeup(now())){
+    sendExecutionEvent(now(), newCallback(this, &FluidNIC::wakeup));
+  }
+}
+
+void
+FluidNIC::settle()
+{
+  Timestamp wakeup_time;
+  if (net_->settle(now(), wakeup_time)){
+    sendExecutionEvent(wakeup_time, newCallback(this, &FluidNIC::wakeup));
+  }
+}
+
+void
+FluidNIC::wakeup()
+{
+  net_->wakeupFired(now());
+  std::vector<NetworkMessage*> done;
+  net_->advance(now(), done);
+  for (NetworkMessage* msg : done){
+    //the source has finished injecting once the last byte arrives
+    if (msg->needsAck()){
+      net_->nic(msg->fromaddr())->sendToNode(msg->cloneInjectionAck());
+    }
+    net_->nic(msg->toaddr())->recvMessage(msg);
+  }
+  settle();
+}
+
+void
+FluidNIC::handleCredit(Event * /*ev*/)
+{
+  spkt_abort_printf("FluidNIC::handleCredit: should not handle credits in fluid model");
+}
+
+}
+} // end of namespace sstmac
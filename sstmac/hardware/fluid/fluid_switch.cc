@@ -0,0 +1,150 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+
+#include <sstmac/hardware/router/router.h>
+#include <sstmac/hardware/fluid/fluid_switch.h>
+#include <sstmac/hardware/topology/topology.h>
+#include <sprockit/util.h>
+#include <sprockit/sim_parameters.h>
+#include <sprockit/keyword_registration.h>
+
+RegisterNamespaces("switch", "router", "link");
+
+RegisterKeywords(
+{ "latency", "latency to traverse a portion of the switch" },
+{ "bandwidth", "the bandwidth of a given link sending" },
+);
+
+namespace sstmac {
+namespace hw {
+
+FluidSwitch::FluidSwitch(uint32_t id, SST::Params& params) :
+  NetworkSwitch(id, params),
+  router_(nullptr),
+  net_(FluidNetwork::get())
+{
+  SST::Params rtr_params = params.find_scoped_params("router");
+  rtr_params.insert("id", std::to_string(my_addr_));
+  router_ = sprockit::create<Router>(
+   "macro", rtr_params.find<std::string>("name"), rtr_params, top_, this);
+
+  SST::Params link_params = params.find_scoped_params("link");
+  link_bw_ = link_params.find<SST::UnitAlgebra>("bandwidth").getValue().toDouble();
+
+  // Ensure topology is set
+  Topology::staticTopology(params);
+
+  ports_.resize(top_->maxNumPorts());
+  for (int i=0; i < ports_.size(); ++i){
+    ports_[i].link_id = FluidNetwork::switchLinkId(my_addr_, i);
+    ports_[i].bandwidth = link_bw_;
+  }
+  initLinks(params);
+}
+
+FluidSwitch::~FluidSwitch()
+{
+  if (router_) delete router_;
+}
+
+void
+FluidSwitch::connectOutput(int src_outport, int  /*dst_inport*/, EventLink::ptr&& link)
+{
+  Port& p = ports_[src_outport];
+  p.link = std::move(link);
+  p.bandwidth = top_->portScaleFactor(my_addr_, src_outport) * link_bw_;
+}
+
+void
+FluidSwitch::connectInput(int /*src_outport*/, int /*dst_inport*/,
+                          EventLink::ptr&& /*link*/)
+{
+  //no-op
+}
+
+int
+FluidSwitch::queueLength(int port, int  /*vc*/) const
+{
+  return net_->numFlows(ports_[port].link_id);
+}
+
+void
+FluidSwitch::handleCredit(Event * /*ev*/)
+{
+  spkt_abort_printf("FluidSwitch::handleCredit: should never be called");
+}
+
+void
+FluidSwitch::handlePayload(Event *ev)
+{
+  FluidPacket* pkt = safe_cast(FluidPacket, ev);
+  router_->route(pkt);
+  Port& p = ports_[pkt->nextPort()];
+  pkt->addHop(p.link_id, p.bandwidth);
+  debug_printf(sprockit::dbg::fluid, "fluid switch %d: forwarding on port %d %s",
+               int(addr()), pkt->nextPort(), pkt->toString().c_str());
+  p.link->send(pkt);
+}
+
+std::string
+FluidSwitch::toString() const
+{
+  return sprockit::sprintf("fluid switch %d", int(my_addr_));
+}
+
+LinkHandler*
+FluidSwitch::creditHandler(int  /*port*/)
+{
+  return newLinkHandler(this, &FluidSwitch::handleCredit);
+}
+
+LinkHandler*
+FluidSwitch::payloadHandler(int  /*port*/)
+{
+  return newLinkHandler(this, &FluidSwitch::handlePayload);
+}
+
+}
+}
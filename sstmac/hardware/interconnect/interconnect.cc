@@ -58,18 +58,27 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/backends/common/sim_partition.h>
 #include <sstmac/common/runtime.h>
 #include <sstmac/common/event_manager.h>
+#include <sstmac/common/thread_lock.h>
 #include <sprockit/keyword_registration.h>
 #include <sprockit/statics.h>
 #include <sprockit/output.h>
 #include <sprockit/sim_parameters.h>
 #include <sprockit/util.h>
 #include <cinttypes>
+#include <limits>
+#include <map>
+#include <pthread.h>
 
 #include <unusedvariablemacro.h>
 
 
 RegisterDebugSlot(interconnect);
 
+RegisterKeywords(
+{ "global_latency", "the latency of switch links on global ports, e.g. dragonfly inter-group links" },
+{ "intra_latency", "the latency of switch links on intra-group ports" },
+);
+
 
 #define interconn_debug(str, ...) \
   debug_printf(sprockit::dbg::interconnect, "Rank %d: " str, EventManager::global->me(), __VA_ARGS__)
@@ -143,6 +152,9 @@ Interconnect::Interconnect(SST::Params& params, SSTMAC_MAYBE_UNUSED EventManager
 
   switches_.resize(num_switches_);
   nodes_.resize(num_nodes_);
+  if (mgr->allowMigration()){
+    switch_links_.resize(num_switches_);
+  }
 
   SST::Params logp_params;
   if (logp_model){
@@ -159,13 +171,33 @@ Interconnect::Interconnect(SST::Params& params, SSTMAC_MAYBE_UNUSED EventManager
     logp_switches_[i] = new LogPSwitch(id, logp_params);
   }
 
+  nthread_ = rt_->nthread();
+  max_num_ports_ = top->maxNumPorts();
+  logp_links_per_node_ = 1 + uint64_t(nproc) * nthread_;
+  switch_link_offset_ = logp_links_per_node_ * num_nodes_;
+  endpoint_link_offset_ = switch_link_offset_ + 2*uint64_t(num_switches_) * max_num_ports_;
+  uint64_t num_link_ids = endpoint_link_offset_ + 4*uint64_t(num_switches_) * max_num_ports_;
+  //self link ids are allocated down from the top of the 32-bit range
+  if (num_link_ids > std::numeric_limits<uint32_t>::max() / 2){
+    spkt_abort_printf("interconnect needs %" PRIu64 " link ids, more than the %" PRIu32 " available",
+                      num_link_ids, std::numeric_limits<uint32_t>::max() / 2);
+  }
+
+  thread_switches_.resize(nthread_);
+  for (int i=0; i < num_switches_; ++i){
+    if (partition_->lpidForSwitch(i) == rt_->me()){
+      local_switches_.push_back(i);
+      thread_switches_[partition_->threadForSwitch(i)].push_back(i);
+    }
+  }
+
   buildEndpoints(node_params, nic_params, mgr);
 
-  uint64_t linkId = connectLogP(0/*number from zero*/, mgr, node_params, nic_params);
+  connectLogP(mgr, node_params, nic_params);
   if (!logp_model){
     buildSwitches(switch_params, mgr);
-    linkId = connectSwitches(linkId, mgr, switch_params);
-    linkId = connectEndpoints(linkId, mgr, nic_params, switch_params);
+    connectSwitches(mgr, switch_params);
+    connectEndpoints(mgr, nic_params, switch_params);
     configureInterconnectLookahead(params);
   } else {
     //lookahead is actually higher
@@ -220,16 +252,65 @@ Interconnect::nodeToLogpSwitch(NodeId nid) const
 
 #if !SSTMAC_INTEGRATED_SST_CORE
 
-uint64_t
-Interconnect::connectEndpoints(uint64_t linkIdOffset,
-                               EventManager* mgr,
+namespace {
+
+struct BuildThread {
+  const std::function<void(int)>* fxn;
+  int thread;
+};
+
+void*
+runBuildThread(void* args)
+{
+  BuildThread* bt = (BuildThread*) args;
+  (*bt->fxn)(bt->thread);
+  return nullptr;
+}
+
+void
+checkPort(SwitchId sid, int port, int max_num_ports)
+{
+  if (port >= max_num_ports){
+    spkt_abort_printf("switch %d port %d exceeds topology max number of ports %d",
+                      int(sid), port, max_num_ports);
+  }
+}
+
+}
+
+void
+Interconnect::forEachThread(EventManager* mgr, const std::function<void(int)>& fxn)
+{
+#if SSTMAC_USE_MULTITHREAD
+  //migratable links are shared between switches on different threads,
+  //so only build in parallel when every thread touches disjoint state
+  if (nthread_ > 1 && !mgr->allowMigration()){
+    std::vector<pthread_t> threads(nthread_);
+    std::vector<BuildThread> args(nthread_);
+    for (int t=1; t < nthread_; ++t){
+      args[t].fxn = &fxn;
+      args[t].thread = t;
+      if (pthread_create(&threads[t], nullptr, runBuildThread, &args[t]) != 0){
+        spkt_abort_printf("interconnect: failed creating construction thread %d", t);
+      }
+    }
+    fxn(0);
+    for (int t=1; t < nthread_; ++t){
+      pthread_join(threads[t], nullptr);
+    }
+    return;
+  }
+#endif
+  for (int t=0; t < nthread_; ++t){
+    fxn(t);
+  }
+}
+
+void
+Interconnect::connectEndpoints(EventManager* mgr,
                                SST::Params& ep_params,
                                SST::Params& sw_params)
 {
-  uint64_t linkId = linkIdOffset;
-  int num_switches = topology_->numSwitches();
-  int me = rt_->me();
-  std::vector<Topology::InjectionPort> ports;
   SST::Params inj_params = ep_params.find_scoped_params("injection");
   SST::Params ej_params = ep_params.find_scoped_params("ejection");
   SST::Params link_params= sw_params.find_scoped_params("link");
@@ -241,55 +322,71 @@ Interconnect::connectEndpoints(uint64_t linkIdOffset,
     ej_latency = TimeDelta(link_params.find<SST::UnitAlgebra>("latency").getValue().toDouble());
   }
 
+  //every endpoint lives on the same rank and thread as its switch
+  forEachThread(mgr, [&](int thread){
+    EventManager* thr_mgr = mgr->threadManager(thread);
+    std::vector<Topology::InjectionPort> ports;
+    for (SwitchId i : thread_switches_[thread]){
+      NetworkSwitch* injsw = switches_[i];
+      NetworkSwitch* ejsw = switches_[i];
+
+      topology_->endpointsConnectedToInjectionSwitch(i, ports);
+      for (Topology::InjectionPort& p : ports){
+        checkPort(i, p.switch_port, max_num_ports_);
+        Node* ep = nodes_[p.nid];
+        uint64_t linkId = injectionLinkId(i, p.switch_port);
+        if (mgr->allowMigration()){
+          interconn_debug("connecting switch %d:%p to injector %d:%p on ports %d:%d with migratable links",
+              int(i), injsw, p.nid, ep, p.switch_port, p.ep_port);
+
+          auto credit_link = new MultithreadLink(linkId, inj_latency, thr_mgr, thr_mgr, ep->creditHandler(p.ep_port));
+          switch_links_[i].out.push_back(credit_link);
+          injsw->connectInput(p.ep_port, p.switch_port, EventLink::ptr(credit_link));
+
+          auto payload_link = new MultithreadLink(linkId+1, inj_latency, thr_mgr, thr_mgr, injsw->payloadHandler(p.switch_port));
+          switch_links_[i].in.push_back(payload_link);
+          ep->connectOutput(p.ep_port, p.switch_port, EventLink::ptr(payload_link));
+        } else {
+          interconn_debug("connecting switch %d:%p to injector %d:%p on ports %d:%d",
+              int(i), injsw, p.nid, ep, p.switch_port, p.ep_port);
 
+          auto credit_link = new LocalLink(linkId, inj_latency, thr_mgr, ep->creditHandler(p.ep_port));
+          injsw->connectInput(p.ep_port, p.switch_port, EventLink::ptr(credit_link));
 
-  for (int i=0; i < num_switches; ++i){
-    //parallel - I don't own this
-    int target_rank = partition_->lpidForSwitch(i);
-    int target_thread = partition_->threadForSwitch(i);
-
-    NetworkSwitch* injsw = switches_[i];
-    NetworkSwitch* ejsw = switches_[i];
-
-    topology_->endpointsConnectedToInjectionSwitch(i, ports);
-    for (Topology::InjectionPort& p : ports){
-      Node* ep = nodes_[p.nid];
-
-
-      if (target_rank == me){
-        interconn_debug("connecting switch %d:%p to injector %d:%p on ports %d:%d",
-            i, injsw, p.nid, ep, p.switch_port, p.ep_port);
-
-        auto credit_link = new LocalLink(linkId++, inj_latency, mgr->threadManager(target_thread), ep->creditHandler(p.ep_port));
-        injsw->connectInput(p.ep_port, p.switch_port, EventLink::ptr(credit_link));
-
-        auto payload_link = new LocalLink(linkId++, inj_latency, mgr->threadManager(target_thread), injsw->payloadHandler(p.switch_port));
-        ep->connectOutput(p.ep_port, p.switch_port, EventLink::ptr(payload_link));
-      } else {
-        //increment the counter for consistent numbering
-        linkId += 2;
+          auto payload_link = new LocalLink(linkId+1, inj_latency, thr_mgr, injsw->payloadHandler(p.switch_port));
+          ep->connectOutput(p.ep_port, p.switch_port, EventLink::ptr(payload_link));
+        }
       }
-    }
 
-    topology_->endpointsConnectedToEjectionSwitch(i, ports);
-    for (Topology::InjectionPort& p : ports){
-      Node* ep = nodes_[p.nid];
-      if (target_rank == me){
-        interconn_debug("connecting switch %d:%p to ejector %d:%p on ports %d:%d",
-            int(i), ejsw, p.nid, ep, p.switch_port, p.ep_port);
+      topology_->endpointsConnectedToEjectionSwitch(i, ports);
+      for (Topology::InjectionPort& p : ports){
+        checkPort(i, p.switch_port, max_num_ports_);
+        Node* ep = nodes_[p.nid];
+        uint64_t linkId = ejectionLinkId(i, p.switch_port);
+        if (mgr->allowMigration()){
+          interconn_debug("connecting switch %d:%p to ejector %d:%p on ports %d:%d with migratable links",
+              int(i), ejsw, p.nid, ep, p.switch_port, p.ep_port);
+
+          auto payload_link = new MultithreadLink(linkId, ej_latency, thr_mgr, thr_mgr, ep->payloadHandler(p.ep_port));
+          switch_links_[i].out.push_back(payload_link);
+          ejsw->connectOutput(p.switch_port, p.ep_port, EventLink::ptr(payload_link));
+
+          auto credit_link = new MultithreadLink(linkId+1, ej_latency, thr_mgr, thr_mgr, ejsw->creditHandler(p.switch_port));
+          switch_links_[i].in.push_back(credit_link);
+          ep->connectInput(p.switch_port, p.ep_port, EventLink::ptr(credit_link));
+        } else {
+          interconn_debug("connecting switch %d:%p to ejector %d:%p on ports %d:%d",
+              int(i), ejsw, p.nid, ep, p.switch_port, p.ep_port);
 
-        auto payload_link = new LocalLink(linkId++, ej_latency, mgr->threadManager(target_thread), ep->payloadHandler(p.ep_port));
-        ejsw->connectOutput(p.switch_port, p.ep_port, EventLink::ptr(payload_link));
+          auto payload_link = new LocalLink(linkId, ej_latency, thr_mgr, ep->payloadHandler(p.ep_port));
+          ejsw->connectOutput(p.switch_port, p.ep_port, EventLink::ptr(payload_link));
 
-        auto credit_link = new LocalLink(linkId++, ej_latency, mgr->threadManager(target_thread), ejsw->creditHandler(p.switch_port));
-        ep->connectInput(p.switch_port, p.ep_port, EventLink::ptr(credit_link));
-      } else {
-        //increment the counter for consistent numbering
-        linkId += 2;
+          auto credit_link = new LocalLink(linkId+1, ej_latency, thr_mgr, ejsw->creditHandler(p.switch_port));
+          ep->connectInput(p.switch_port, p.ep_port, EventLink::ptr(credit_link));
+        }
       }
     }
-  }
-  return linkId;
+  });
 }
 
 void
@@ -317,101 +414,88 @@ Interconnect::setup()
   }
 }
 
-uint64_t
+void
 Interconnect::connectLogP(
-  uint64_t linkIdOffset,
   EventManager* mgr,
   SST::Params&  /*node_params*/,
-  SST::Params& nic_params)
+  SST::Params& /*nic_params*/)
 {
-  SST::Params inj_params = nic_params.get_namespace("injection");
-  SST::Params empty{};
-
   int my_rank = rt_->me();
 
-  uint64_t linkId = linkIdOffset;
-
+  //not every topology implements endpointToSwitch, so map nodes through their injection switches
+  std::vector<SwitchId> node_switches(num_nodes_);
+  std::vector<Topology::InjectionPort> ports;
   for (int i=0; i < num_switches_; ++i){
-    SwitchId sid(i);
-    std::vector<Topology::InjectionPort> nodes;
-    topology_->endpointsConnectedToInjectionSwitch(sid, nodes);
-    if (nodes.empty())
-      continue;
+    topology_->endpointsConnectedToInjectionSwitch(i, ports);
+    for (Topology::InjectionPort& p : ports){
+      node_switches[p.nid] = i;
+    }
+  }
 
-    int target_thread = partition_->threadForSwitch(sid);
-    int target_rank = partition_->lpidForSwitch(sid);
-    LogPSwitch* local_logp_switch = logp_switches_[target_thread];
+  forEachThread(mgr, [&](int thread){
+    EventManager* thr_mgr = mgr->threadManager(thread);
+    LogPSwitch* local_logp_switch = logp_switches_[thread];
     TimeDelta logp_link_latency = local_logp_switch->out_in_latency();
 
-    for (Topology::InjectionPort& conn : nodes){
-      Node* nd = nodes_[conn.nid];
-      interconn_debug("Node %d links start at %" PRIu64, conn.nid, linkId);
-      if (target_rank == my_rank){
+    std::vector<Topology::InjectionPort> nodes;
+    for (SwitchId sid : thread_switches_[thread]){
+      topology_->endpointsConnectedToInjectionSwitch(sid, nodes);
+      for (Topology::InjectionPort& conn : nodes){
+        Node* nd = nodes_[conn.nid];
+        uint64_t linkId = logpLinkId(conn.nid);
         //connect the node output link to its local logp switch
         interconn_debug("connecting NIC %d to its local LogP switch on link %" PRIu64,
                         nd->addr(), linkId);
-        auto* logp_link = new LocalLink(linkId++, TimeDelta(0), mgr->threadManager(target_thread),
+        auto* logp_link = new LocalLink(linkId, TimeDelta(0), thr_mgr,
                                         local_logp_switch->payloadHandler(conn.switch_port));
         nd->nic()->connectOutput(NIC::LogP, conn.switch_port, EventLink::ptr(logp_link));
-      } else {
-        linkId++; //keep consistent
-      }
 
-      //make the IPC handlers available on the ports/links expected
-      for (int rank=0; rank < rt_->me(); ++rank){
-        for (int logp=0; logp < mgr->nthread(); ++logp){
-          if (target_rank == my_rank){
+        //make the IPC handlers available on the links the LogP switches on other ranks send to
+        for (int rank=0; rank < rt_->nproc(); ++rank){
+          if (rank == my_rank) continue;
+          for (int logp=0; logp < nthread_; ++logp){
+            linkId = logpOutLinkId(conn.nid, rank, logp);
             interconn_debug("making NIC %d payload handler available on link %" PRIu64,
                             nd->addr(), linkId);
-            auto* handler = nd->payloadHandler(NIC::LogP);
-            mgr->threadManager(target_thread)->addLinkHandler(linkId++, handler);
-          } else {
-            //increment to keep numbering consistent
-            linkId++;
+            thr_mgr->addLinkHandler(linkId, nd->payloadHandler(NIC::LogP));
           }
         }
       }
+    }
 
-      //connect the logp output to this node using local/multi-thread links
-      for (int logp=0; logp < mgr->nthread(); ++logp){
-        if (my_rank == target_rank && logp == target_thread){
-          interconn_debug("connecting LogP %d:%d:%d to NIC %d:%d on local link %" PRIu64,
-                          rt_->me(), logp, conn.nid, conn.nid, NIC::LogP, linkId);
-          auto* out_link = new LocalLink(linkId++, logp_link_latency, mgr->threadManager(target_thread),
-                                         nd->payloadHandler(NIC::LogP));
-          logp_switches_[logp]->connectOutput(conn.nid, EventLink::ptr(out_link));
-        } else if (my_rank == target_rank) {
-          interconn_debug("connecting LogP %d:%d:%d to NIC %d:%d on MT link %" PRIu64,
-                          rt_->me(), logp, conn.nid, conn.nid, NIC::LogP, linkId);
-          auto* out_link = new MultithreadLink(linkId++, logp_link_latency, mgr->threadManager(logp),
-                                               mgr->threadManager(target_thread),
-                                               nd->payloadHandler(NIC::LogP));
-          logp_switches_[logp]->connectOutput(conn.nid, EventLink::ptr(out_link));
-        } else {
-          interconn_debug("connecting LogP %d:%d:%d to NIC %d:%d on IPC link %" PRIu64,
-                          rt_->me(), logp, conn.nid, conn.nid, NIC::LogP, linkId);
-          auto* out_link = new IpcLink(linkId++, logp_link_latency, target_rank, target_thread,
-                                       mgr->threadManager(logp), mgr);
-          logp_switches_[logp]->connectOutput(conn.nid, EventLink::ptr(out_link));
+    //connect this thread's logp switch to every node using local/multi-thread/IPC links
+    for (NodeId nid=0; nid < num_nodes_; ++nid){
+      SwitchId sid = node_switches[nid];
+      int target_rank = partition_->lpidForSwitch(sid);
+      int target_thread = partition_->threadForSwitch(sid);
+      uint64_t linkId = logpOutLinkId(nid, my_rank, thread);
+      EventLink* out_link = nullptr;
+      if (target_rank == my_rank){
+        Node* nd = nodes_[nid];
+        if (!nd){
+          spkt_abort_printf("node %d is not connected to any injection switch", int(nid));
         }
-      }
-
-      for (int rank=rt_->me()+1; rank < rt_->nproc(); ++rank){
-        for (int logp=0; logp < mgr->nthread(); ++logp){
-          if (target_rank == my_rank){
-            interconn_debug("making NIC %d payload handler available on link %" PRIu64,
-                            nd->addr(), linkId);
-            auto* handler = nd->payloadHandler(NIC::LogP);
-            mgr->threadManager(target_thread)->addLinkHandler(linkId++, handler);
-          } else {
-            //increment to keep numbering consistent
-            linkId++;
-          }
+        if (target_thread == thread){
+          interconn_debug("connecting LogP %d:%d to NIC %d:%d on local link %" PRIu64,
+                          my_rank, thread, nid, NIC::LogP, linkId);
+          out_link = new LocalLink(linkId, logp_link_latency, thr_mgr,
+                                   nd->payloadHandler(NIC::LogP));
+        } else {
+          interconn_debug("connecting LogP %d:%d to NIC %d:%d on MT link %" PRIu64,
+                          my_rank, thread, nid, NIC::LogP, linkId);
+          out_link = new MultithreadLink(linkId, logp_link_latency, thr_mgr,
+                                         mgr->threadManager(target_thread),
+                                         nd->payloadHandler(NIC::LogP));
         }
+      } else {
+        interconn_debug("connecting LogP %d:%d to NIC %d:%d on IPC link %" PRIu64,
+                        my_rank, thread, nid, NIC::LogP, linkId);
+        out_link = new IpcLink(linkId, logp_link_latency, target_rank, target_thread,
+                               thr_mgr, mgr);
       }
+      local_logp_switch->connectOutput(nid, EventLink::ptr(out_link));
     }
-  }
-  return linkId;
+  });
 }
 
 void
@@ -419,37 +503,26 @@ Interconnect::buildEndpoints(SST::Params& node_params,
                   SST::Params&  /*nic_params*/,
                   EventManager* mgr)
 {
-  int my_rank = rt_->me();
-
-  for (int i=0; i < num_switches_; ++i){
-    SwitchId sid(i);
-    std::vector<Topology::InjectionPort> nodes;
+  std::vector<Topology::InjectionPort> nodes;
+  for (SwitchId sid : local_switches_){
     topology_->endpointsConnectedToInjectionSwitch(sid, nodes);
-    if (nodes.empty())
-      continue;
-    int target_rank = partition_->lpidForSwitch(sid);
     int target_thread = partition_->threadForSwitch(sid);
-    interconn_debug("switch %d maps to target rank %d, target thread %d",
-                    i, target_rank, target_thread);
-
+    interconn_debug("switch %d maps to target thread %d", int(sid), target_thread);
     for (int n=0; n < nodes.size(); ++n){
       NodeId nid = nodes[n].nid;
-      if (my_rank == target_rank){
-        //local node - actually build it
-        node_params->addParamOverride("id", int(nid));
-        uint32_t comp_id = nid;
-        auto nodeType = node_params.find<std::string>("name", "simple");
-        auto pos = nodeType.find("_node"); //append the node prefix if missing
-        if (pos == std::string::npos){
-          nodeType = nodeType + "_node";
-        }
-        interconn_debug("set node %d component %u to thread %d", n, comp_id, target_thread);
-        mgr->setComponentManager(comp_id, target_thread);
-        Node* nd = sprockit::create<Node>("macro", nodeType, comp_id, node_params);
-        node_params->removeParam("id"); //you don't have to let it linger
-        nodes_[nid] = nd;
-        components_[nid] = nd;
+      node_params->addParamOverride("id", int(nid));
+      uint32_t comp_id = nid;
+      auto nodeType = node_params.find<std::string>("name", "simple");
+      auto pos = nodeType.find("_node"); //append the node prefix if missing
+      if (pos == std::string::npos){
+        nodeType = nodeType + "_node";
       }
+      interconn_debug("set node %d component %u to thread %d", n, comp_id, target_thread);
+      mgr->setComponentManager(comp_id, target_thread);
+      Node* nd = sprockit::create<Node>("macro", nodeType, comp_id, node_params);
+      node_params->removeParam("id"); //you don't have to let it linger
+      nodes_[nid] = nd;
+      components_[nid] = nd;
     }
   }
 }
@@ -461,24 +534,22 @@ Interconnect::buildSwitches(SST::Params& switch_params,
   bool simple_model = switch_params.find<std::string>("name") == "simple";
   if (simple_model) return; //nothing to do
 
-  int my_rank = rt_->me();
   int id_offset = topology_->numNodes();
-  for (SwitchId i=0; i < num_switches_; ++i){
+  for (SwitchId i : local_switches_){
     switch_params->addParamOverride("id", int(i));
-    if (partition_->lpidForSwitch(i) == my_rank){
-      int thread = partition_->threadForSwitch(i);
-      uint32_t comp_id = switchComponentId(i);
-      auto swType = switch_params.find<std::string>("name");
-      auto pos = swType.find("_switch"); //append the switch prefix if missing
-      if (pos == std::string::npos){
-        swType = swType + "_switch";
-      }
-      interconn_debug("set switch %d component %u to thread %d", i, comp_id, thread);
-      mgr->setComponentManager(comp_id, thread);
-      switches_[i] = sprockit::create<NetworkSwitch>("macro", swType, comp_id, switch_params);
-    } else {
-      switches_[i] = nullptr;
+    int thread = partition_->threadForSwitch(i);
+    uint32_t comp_id = switchComponentId(i);
+    auto swType = switch_params.find<std::string>("name");
+    auto pos = swType.find("_switch"); //append the switch prefix if missing
+    if (pos == std::string::npos){
+      swType = swType + "_switch";
     }
+    interconn_debug("set switch %d component %u to thread %d", i, comp_id, thread);
+    mgr->setComponentManager(comp_id, thread);
+    if (mgr->allowMigration()){
+      mgr->addMigratableComponent(comp_id);
+    }
+    switches_[i] = sprockit::create<NetworkSwitch>("macro", swType, comp_id, switch_params);
     switch_params->removeParam("id");
     components_[i+id_offset] = switches_[i];
   }
@@ -507,6 +578,33 @@ Interconnect::deadlockCheck()
   }
 }
 
+void
+Interconnect::switchLinks(SwitchId sid, std::vector<uint32_t>& links) const
+{
+  for (MultithreadLink* link : switch_links_[sid].in){
+    links.push_back(link->id());
+  }
+  EventManager::global->selfLinks(switchComponentId(sid), links);
+}
+
+void
+Interconnect::migrateSwitch(SwitchId sid, int thread)
+{
+  EventManager* new_mgr = EventManager::global->threadManager(thread);
+  std::vector<uint32_t> links;
+  for (MultithreadLink* link : switch_links_[sid].in){
+    link->setDstManager(new_mgr);
+    links.push_back(link->id());
+  }
+  for (MultithreadLink* link : switch_links_[sid].out){
+    link->setSrcManager(new_mgr);
+  }
+  interconn_debug("migrating switch %d from thread %d to thread %d",
+                  int(sid), partition_->threadForSwitch(sid), thread);
+  EventManager::global->migrateComponent(switchComponentId(sid), thread, links);
+  partition_->setThreadForSwitch(sid, thread);
+}
+
 uint32_t
 Interconnect::logpComponentId(SwitchId sid) const
 {
@@ -514,103 +612,174 @@ Interconnect::logpComponentId(SwitchId sid) const
   return my_offset + sid;
 }
 
-uint64_t
-Interconnect::connectSwitches(uint64_t linkIdOffset, EventManager* mgr, SST::Params& switch_params)
+void
+Interconnect::connectSwitches(EventManager* mgr, SST::Params& switch_params)
 {
   bool simple_model = switch_params.find<std::string>("name") == "simple";
-  if (simple_model) return linkIdOffset; //nothing to do
-
-  std::vector<Topology::Connection> outports(64); //allocate 64 spaces optimistically
+  if (simple_model) return; //nothing to do
 
   int my_rank = rt_->me();
-  int my_thread = mgr->thread();
-  uint64_t linkId = linkIdOffset;
 
   SST::Params port_params = switch_params.get_namespace("link");
-  TimeDelta linkLatency(port_params.find<SST::UnitAlgebra>("latency").getValue().toDouble());
-
-  for (int i=0; i < num_switches_; ++i){
-    interconn_debug("interconnect: connecting switch %i", i);
-    SwitchId src(i);
-    int src_rank = partition_->lpidForSwitch(i);
-    int src_thread = partition_->threadForSwitch(i);
-    topology_->connectedOutports(src, outports);
-    for (Topology::Connection& conn : outports){
-      int dst_rank = partition_->lpidForSwitch(conn.dst);
-      int dst_thread = partition_->threadForSwitch(conn.dst);
-
-      interconn_debug("%s connecting to %s on ports %d:%d",
-                topology_->switchLabel(src).c_str(),
-                topology_->switchLabel(conn.dst).c_str(),
-                conn.src_outport, conn.dst_inport);
-
-      if (dst_rank == my_rank && src_rank != my_rank){
-        //we need to make the credit handler available on this end - its link is the next one
-        auto* payload_handler = switches_[conn.dst]->payloadHandler(conn.dst_inport);
-        interconn_debug("switch %d:%d making payload handler available on IPC link %" PRIu64,
-                         conn.dst, conn.dst_inport, linkId);
-        mgr->threadManager(dst_thread)->addLinkHandler(linkId, payload_handler);
+  TimeDelta defaultLatency(port_params.find<SST::UnitAlgebra>("latency").getValue().toDouble());
+  //some port types, e.g. dragonfly global links, can be given a longer latency
+  std::map<std::string,TimeDelta> portLatencies;
+  thread_lock latency_lock;
+  auto portLatency = [&](SwitchId sid, int port) -> TimeDelta {
+    std::string portType = topology_->portTypeName(sid, port);
+    latency_lock.lock();
+    auto iter = portLatencies.find(portType);
+    if (iter == portLatencies.end()){
+      std::string key = portType + "_latency";
+      TimeDelta lat = defaultLatency;
+      if (port_params.contains(key)){
+        lat = TimeDelta(port_params.find<SST::UnitAlgebra>(key).getValue().toDouble());
+        if (lat < defaultLatency){
+          spkt_abort_printf("switch.link.%s=%8.4e is less than switch.link.latency=%8.4e",
+                            key.c_str(), lat.sec(), defaultLatency.sec());
+        }
+      }
+      iter = portLatencies.emplace(portType, lat).first;
+    }
+    TimeDelta lat = iter->second;
+    latency_lock.unlock();
+    return lat;
+  };
+
+  //inbound[writer][dst_thread] collects the links into switches on dst_thread
+  //so the second pass never has to search the topology for its inports
+  std::vector<std::vector<std::vector<Topology::Connection>>> inbound(nthread_);
+  for (auto& vec : inbound) vec.resize(nthread_);
+
+  //first pass: build the payload links out of every local switch.
+  //some switches only build their output buffers, which own the credit handlers,
+  //when their outputs are connected - so no credit handlers are requested until the second pass
+  forEachThread(mgr, [&](int src_thread){
+    EventManager* thr_mgr = mgr->threadManager(src_thread);
+    std::vector<Topology::Connection> outports(64); //allocate 64 spaces optimistically
+    //each thread takes a share of the remote switches that might link into this rank
+    for (int i=src_thread; i < num_switches_; i += nthread_){
+      SwitchId src(i);
+      if (partition_->lpidForSwitch(src) == my_rank) continue;
+      topology_->connectedOutports(src, outports);
+      for (Topology::Connection& conn : outports){
+        if (partition_->lpidForSwitch(conn.dst) == my_rank){
+          checkPort(src, conn.src_outport, max_num_ports_);
+          inbound[src_thread][partition_->threadForSwitch(conn.dst)].push_back(conn);
+        }
       }
+    }
+
+    for (SwitchId src : thread_switches_[src_thread]){
+      interconn_debug("interconnect: connecting switch %i", int(src));
+      topology_->connectedOutports(src, outports);
+      for (Topology::Connection& conn : outports){
+        checkPort(src, conn.src_outport, max_num_ports_);
+        int dst_rank = partition_->lpidForSwitch(conn.dst);
+        int dst_thread = partition_->threadForSwitch(conn.dst);
+        TimeDelta linkLatency = portLatency(src, conn.src_outport);
+        uint64_t linkId = switchLinkId(src, conn.src_outport);
+
+        interconn_debug("%s connecting to %s on ports %d:%d",
+                  topology_->switchLabel(src).c_str(),
+                  topology_->switchLabel(conn.dst).c_str(),
+                  conn.src_outport, conn.dst_inport);
 
-      if (src_rank == my_rank){
         EventLink* payload_link = nullptr;
-        if (dst_rank == my_rank && dst_thread == src_thread){
+        if (dst_rank == my_rank && mgr->allowMigration()){
+          interconn_debug("connecting switches %d:%d->%d:%d on migratable link %" PRIu64,
+                          conn.src, conn.src_outport, conn.dst, conn.dst_inport, linkId);
+          auto* link = new MultithreadLink(linkId, linkLatency, thr_mgr,
+                                           mgr->threadManager(dst_thread),
+                                           switches_[conn.dst]->payloadHandler(conn.dst_inport));
+          switch_links_[src].out.push_back(link);
+          switch_links_[conn.dst].in.push_back(link);
+          payload_link = link;
+        } else if (dst_rank == my_rank && dst_thread == src_thread){
           interconn_debug("connecting switches %d:%d->%d:%d on local link %" PRIu64,
                           conn.src, conn.src_outport, conn.dst, conn.dst_inport,linkId);
-          payload_link = new LocalLink(linkId++, linkLatency, mgr->threadManager(src_thread),
+          payload_link = new LocalLink(linkId, linkLatency, thr_mgr,
                                        switches_[conn.dst]->payloadHandler(conn.dst_inport));
         } else if (dst_rank == my_rank){
           interconn_debug("connecting switches %d:%d->%d:%d on MT link %" PRIu64,
                           conn.src, conn.src_outport, conn.dst, conn.dst_inport, linkId);
-          payload_link = new MultithreadLink(linkId++, linkLatency, mgr->threadManager(src_thread),
-                                             EventManager::global->threadManager(dst_thread),
+          payload_link = new MultithreadLink(linkId, linkLatency, thr_mgr,
+                                             mgr->threadManager(dst_thread),
                                              switches_[conn.dst]->payloadHandler(conn.dst_inport));
         } else {
           interconn_debug("connecting switches %d:%d->%d:%d on IPC link %" PRIu64,
                           conn.src, conn.src_outport, conn.dst, conn.dst_inport, linkId);
-          payload_link = new IpcLink(linkId++, linkLatency, dst_rank, dst_thread,
-                                     mgr->threadManager(src_thread), mgr);
+          payload_link = new IpcLink(linkId, linkLatency, dst_rank, dst_thread, thr_mgr, mgr);
         }
         switches_[src]->connectOutput(conn.src_outport, conn.dst_inport, EventLink::ptr(payload_link));
-      } else {
-        linkId++; //increment for consistency with other ranks
-      }
 
-      if (dst_rank != my_rank && src_rank == my_rank){
-        //we need to make the credit handler available on this end - its link is the next one
-        auto* credit_handler = switches_[conn.src]->creditHandler(conn.src_outport);
-        interconn_debug("switch %d:%d making payload handler available on IPC link %" PRIu64,
-                         conn.src, conn.src_outport, linkId);
-        mgr->threadManager(src_thread)->addLinkHandler(linkId, credit_handler);
+        if (dst_rank == my_rank){
+          inbound[src_thread][dst_thread].push_back(conn);
+        } else {
+          //we need to make the credit handler available on this end - its link is the next one
+          auto* credit_handler = switches_[src]->creditHandler(conn.src_outport);
+          interconn_debug("switch %d:%d making credit handler available on IPC link %" PRIu64,
+                           int(src), conn.src_outport, linkId + 1);
+          thr_mgr->addLinkHandler(linkId + 1, credit_handler);
+        }
       }
+    }
+  });
+
+  //second pass: build the credit links out of every local switch
+  //back to the switches that send payloads into it
+  forEachThread(mgr, [&](int dst_thread){
+    EventManager* thr_mgr = mgr->threadManager(dst_thread);
+    for (int writer=0; writer < nthread_; ++writer){
+      for (Topology::Connection& conn : inbound[writer][dst_thread]){
+        SwitchId src = conn.src;
+        SwitchId dst = conn.dst;
+        int src_outport = conn.src_outport;
+        int dst_inport = conn.dst_inport;
+        int src_rank = partition_->lpidForSwitch(src);
+        int src_thread = partition_->threadForSwitch(src);
+        TimeDelta linkLatency = portLatency(src, src_outport);
+        uint64_t linkId = switchLinkId(src, src_outport);
+
+        if (src_rank != my_rank){
+          //we need to make the payload handler available on this end - its link is the remote outport link
+          auto* payload_handler = switches_[dst]->payloadHandler(dst_inport);
+          interconn_debug("switch %d:%d making payload handler available on IPC link %" PRIu64,
+                           int(dst), dst_inport, linkId);
+          thr_mgr->addLinkHandler(linkId, payload_handler);
+        }
 
-      if (dst_rank == my_rank){
+        linkId++; //the credit link follows the payload link
         EventLink* credit_link = nullptr;
-        if (src_rank == my_rank && src_thread == dst_thread){
+        if (src_rank == my_rank && mgr->allowMigration()){
+          interconn_debug("connecting switches %d:%d<-%d:%d on migratable link %" PRIu64,
+                          int(src), src_outport, int(dst), dst_inport, linkId);
+          auto* link = new MultithreadLink(linkId, linkLatency, thr_mgr,
+                                           mgr->threadManager(src_thread),
+                                           switches_[src]->creditHandler(src_outport));
+          switch_links_[dst].out.push_back(link);
+          switch_links_[src].in.push_back(link);
+          credit_link = link;
+        } else if (src_rank == my_rank && src_thread == dst_thread){
           interconn_debug("connecting switches %d:%d<-%d:%d on local link %" PRIu64,
-                          conn.src, conn.src_outport, conn.dst, conn.dst_inport, linkId);
-          credit_link = new LocalLink(linkId++, linkLatency, mgr->threadManager(dst_thread),
-                                      switches_[src]->creditHandler(conn.src_outport));
+                          int(src), src_outport, int(dst), dst_inport, linkId);
+          credit_link = new LocalLink(linkId, linkLatency, thr_mgr,
+                                      switches_[src]->creditHandler(src_outport));
         } else if (src_rank == my_rank) {
           interconn_debug("connecting switches %d:%d<-%d:%d on MT link %" PRIu64,
-                          conn.src, conn.src_outport, conn.dst, conn.dst_inport, linkId);
-          credit_link = new MultithreadLink(linkId++, linkLatency, mgr->threadManager(dst_thread),
-                                            EventManager::global->threadManager(src_thread),
-                                            switches_[src]->creditHandler(conn.src_outport));
+                          int(src), src_outport, int(dst), dst_inport, linkId);
+          credit_link = new MultithreadLink(linkId, linkLatency, thr_mgr,
+                                            mgr->threadManager(src_thread),
+                                            switches_[src]->creditHandler(src_outport));
         } else {
           interconn_debug("connecting switches %d:%d<-%d:%d on IPC link %" PRIu64,
-                          conn.src, conn.src_outport, conn.dst, conn.dst_inport, linkId);
-          //we need to make the payload handler available on this end - its link is this one
-          credit_link = new IpcLink(linkId++, linkLatency, src_rank, src_thread,
-                                    mgr->threadManager(dst_thread), mgr);
+                          int(src), src_outport, int(dst), dst_inport, linkId);
+          credit_link = new IpcLink(linkId, linkLatency, src_rank, src_thread, thr_mgr, mgr);
         }
-        switches_[conn.dst]->connectInput(conn.src_outport, conn.dst_inport, EventLink::ptr(credit_link));
-      } else {
-        linkId++; //increment for consistency with other ranks
+        switches_[dst]->connectInput(src_outport, dst_inport, EventLink::ptr(credit_link));
       }
     }
-  }
-  return linkId;
+  });
 }
 #endif
 
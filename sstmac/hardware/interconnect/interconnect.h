@@ -61,6 +61,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sprockit/debug.h>
 #include <sprockit/factory.h>
 #include <unordered_map>
+#include <functional>
 
 #include <set>
 
@@ -163,6 +164,23 @@ class Interconnect
     return components_[id];
   }
 
+  /**
+   * @brief migrateSwitch
+   * Move a local switch and its pending events to another thread on this rank.
+   * Only valid if the event manager allows migration, in which case every
+   * link to or from a switch is built as a MultithreadLink that can be retargeted.
+   * @param sid
+   * @param thread
+   */
+  void migrateSwitch(SwitchId sid, int thread);
+
+  /**
+   * @brief switchLinks
+   * @param sid A local switch
+   * @param links [out] The IDs of every link delivering events to the switch, including self links
+   */
+  void switchLinks(SwitchId sid, std::vector<uint32_t>& links) const;
+
  private:
   uint32_t switchComponentId(SwitchId sid) const;
 
@@ -172,33 +190,82 @@ class Interconnect
 
   /**
    * @brief connectLogP
-   * @param idOffset The offset to use for starting to number links
+   * Connect the nodes of local switches to their LogP switch and
+   * every local LogP switch to every node
    * @param mgr
    * @param node_params
    * @param nic_params
-   * @return The next available link ID offset after connections
    */
-  uint64_t connectLogP(uint64_t idOffset, EventManager* mgr,
+  void connectLogP(EventManager* mgr,
         SST::Params& node_params, SST::Params& nic_params);
 
   /**
    * @brief connectSwitches
-   * @param idOffset The offset to use for starting to number links
+   * Connect every local switch to its neighbors. Each worker thread
+   * wires the switches it owns, so remote switches are never visited.
    * @param mgr
    * @param switch_params
-   * @return The next available link ID offset after connections
    */
-  uint64_t connectSwitches(uint64_t idOffset, EventManager* mgr, SST::Params& switch_params);
+  void connectSwitches(EventManager* mgr, SST::Params& switch_params);
 
   /**
    * @brief connectEndpoints
-   * @param idOffset The offset to use for starting to number links
    * @param mgr
    * @param ep_params
    * @param sw_params
-   * @return The next available link ID offset after connections
    */
-  uint64_t connectEndpoints(uint64_t idOffset, EventManager* mgr, SST::Params& ep_params, SST::Params& sw_params);
+  void connectEndpoints(EventManager* mgr, SST::Params& ep_params, SST::Params& sw_params);
+
+  /**
+   * @brief forEachThread
+   * Run a construction step once per worker thread,
+   * concurrently if multithreading is enabled
+   * @param mgr
+   * @param fxn Called with the thread index
+   */
+  void forEachThread(EventManager* mgr, const std::function<void(int)>& fxn);
+
+  /**
+   * Link IDs are a closed-form function of the switch, port or node.
+   * Every rank computes the same ID for a link without visiting the
+   * switches it does not own. The regions are, in order:
+   * LogP links per node, switch links per (switch, outport),
+   * and endpoint links per (switch, port).
+   */
+  uint64_t logpLinkId(NodeId nid) const {
+    return uint64_t(nid) * logp_links_per_node_;
+  }
+
+  /**
+   * @return The ID of the LogP link from a LogP switch on (rank,thread) to a node
+   */
+  uint64_t logpOutLinkId(NodeId nid, int rank, int thread) const {
+    return logpLinkId(nid) + 1 + uint64_t(rank) * nthread_ + thread;
+  }
+
+  /**
+   * @return The ID of the payload link out of a switch port.
+   *         The credit link returning to the port is the next ID.
+   */
+  uint64_t switchLinkId(SwitchId sid, int outport) const {
+    return switch_link_offset_ + 2*(uint64_t(sid) * max_num_ports_ + outport);
+  }
+
+  /**
+   * @return The ID of the credit link back to a node injecting into a switch port.
+   *         The node's payload link into the port is the next ID.
+   */
+  uint64_t injectionLinkId(SwitchId sid, int port) const {
+    return endpoint_link_offset_ + 4*uint64_t(sid) * max_num_ports_ + 2*port;
+  }
+
+  /**
+   * @return The ID of the payload link out of a switch port to a node.
+   *         The node's credit link back to the port is the next ID.
+   */
+  uint64_t ejectionLinkId(SwitchId sid, int port) const {
+    return injectionLinkId(sid, port) + 2*max_num_ports_;
+  }
 
   void configureInterconnectLookahead(SST::Params& params);
 
@@ -221,6 +288,28 @@ class Interconnect
 
   std::vector<LogPSwitch*> logp_switches_;
 
+  struct MigratableLinks {
+    /** Links delivering events to the switch */
+    std::vector<MultithreadLink*> in;
+    /** Links sending events from the switch */
+    std::vector<MultithreadLink*> out;
+  };
+
+  /** Only filled in if the event manager allows migration */
+  std::vector<MigratableLinks> switch_links_;
+
+  /** The switches this rank owns, in increasing order */
+  std::vector<SwitchId> local_switches_;
+
+  /** The switches this rank owns, indexed by the worker thread they run on */
+  std::vector<std::vector<SwitchId>> thread_switches_;
+
+  int nthread_;
+  int max_num_ports_;
+  uint64_t logp_links_per_node_;
+  uint64_t switch_link_offset_;
+  uint64_t endpoint_link_offset_;
+
   Partition* partition_;
   ParallelRuntime* rt_;
 #endif
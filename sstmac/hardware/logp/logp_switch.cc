@@ -67,6 +67,7 @@ RegisterKeywords(
  { "random_seed", "a seed for creating randomized message arrivals"},
  { "random_max_extra_latency", "the maximum extra latency allowed in random scenarios"},
  { "random_max_extra_byte_delay", "the maximum extra delay per byte in random scenarios"},
+ { "seed", "the seed for the sliding contention model"},
 );
 
 namespace sstmac {
@@ -74,7 +75,7 @@ namespace hw {
 
 LogPSwitch::LogPSwitch(uint32_t cid, SST::Params& params) :
   ConnectableComponent(cid, params),
-  rng_(nullptr), contention_model_(nullptr)
+  random_noise_(false), contention_model_(nullptr)
 {
   SST::Params topParams;
   top_ = Topology::staticTopology(topParams);
@@ -88,7 +89,7 @@ LogPSwitch::LogPSwitch(uint32_t cid, SST::Params& params) :
 
   if (params.contains("random_seed")){
     random_seed_ = params.find<int>("random_seed");
-    rng_ = RNG::MWC::construct();
+    random_noise_ = true;
     random_max_extra_latency_ = TimeDelta(params.find<SST::UnitAlgebra>("random_max_extra_latency").getValue().toDouble());
     random_max_extra_byte_delay_ = TimeDelta(params.find<SST::UnitAlgebra>("random_max_extra_byte_delay").getValue().toDouble());
   }
@@ -106,7 +107,7 @@ LogPSwitch::LogPSwitch(uint32_t cid, SST::Params& params) :
 
 LogPSwitch::~LogPSwitch()
 {
-  if (rng_) delete rng_;
+  if (contention_model_) delete contention_model_;
   // JJW 4/10/19 these are now owned by the interconnect
   //for (auto* link : nic_links_){
   //  delete link;
@@ -126,19 +127,23 @@ void
 LogPSwitch::send(Timestamp start, NetworkMessage* msg)
 {
   TimeDelta delay;
-  if (rng_){
+  if (random_noise_){
+    //key on the source node and flow rather than this switch
+    //so the noise does not depend on which thread handles the message
     uint64_t t = start.time.ticks();
-    t = ((t*random_seed_) << 5) + random_seed_;
-    uint32_t z = (uint32_t)((t & 0xFFFFFFFF00000000LL) >> 32);
-    uint32_t w = (uint32_t)(t & 0xFFFFFFFFLL);
-    rng_->reseed(z, w);
-    double lat_inc = rng_->realvalue();
+    uint64_t flow = msg->flowId();
+    RNG::rngint_t key[2] = {random_seed_, RNG::rngint_t(msg->fromaddr())};
+    RNG::rngint_t ctr[4] = {RNG::rngint_t(flow), RNG::rngint_t(flow >> 32),
+                            RNG::rngint_t(t), RNG::rngint_t(t >> 32)};
+    RNG::rngint_t draws[4];
+    RNG::Philox::block(key, ctr, draws);
+    double scale = std::numeric_limits<RNG::rngint_t>::max();
+    double lat_inc = draws[0] / scale;
     delay += lat_inc * random_max_extra_latency_;
-    double bw_inc = rng_->realvalue();
+    double bw_inc = draws[1] / scale;
     delay += msg->byteLength() * bw_inc * random_max_extra_byte_delay_;
   } else if (contention_model_) {
-    double contention = contention_model_->value();
-    delay += msg->byteLength() * byte_delay_ * contention;
+    delay += contention_model_->delay(start, msg, byte_delay_);
   }
 
   NodeId dst = msg->toaddr();
@@ -179,12 +184,22 @@ struct SlidingContentionModel : public LogPSwitch::ContentionModel
       cutoffs_[1] = 90;
     }
 
-    std::random_device rd;  //Will be used to obtain a seed for the random number engine
-    std::mt19937 gen(rd()); //Standard mersenne_twister_engine seeded with rd()
-    state_ = gen();
+    if (params.contains("seed")){
+      //xorshift gets stuck at zero
+      state_ = params.find<long>("seed") | 1;
+    } else {
+      std::random_device rd;  //Will be used to obtain a seed for the random number engine
+      std::mt19937 gen(rd()); //Standard mersenne_twister_engine seeded with rd()
+      state_ = gen();
+    }
+  }
+
+  TimeDelta delay(Timestamp  /*start*/, NetworkMessage* msg, TimeDelta byte_delay) override {
+    return msg->byteLength() * byte_delay * value();
   }
 
-  double value() override {
+ private:
+  double value() {
     int num = xorshift64() % range_;
     for (int i=cutoffs_.size() - 1; i >= 0; --i){
       if (num > cutoffs_[i]){
@@ -194,7 +209,6 @@ struct SlidingContentionModel : public LogPSwitch::ContentionModel
     return 0; //no contention
   }
 
- private:
   uint64_t xorshift64()
   {
     uint64_t x = state_;
@@ -212,6 +226,79 @@ struct SlidingContentionModel : public LogPSwitch::ContentionModel
 };
 
 
+/**
+ * @brief The LoadContentionModel class charges messages for the traffic
+ * already queued on the network links of their source switch. Each switch
+ * keeps a single busy-until time for the aggregate of its network links,
+ * so the bytes in flight decay linearly at the aggregate link bandwidth.
+ * A message occupies as many links as it has hops, and waits until the
+ * backlog ahead of it has drained. Nothing is random, and because a switch
+ * and its nodes always share a thread, a switch's backlog only ever sees
+ * traffic in the same event order regardless of thread count.
+ * Injection and ejection serialization is already modeled by the LogP NIC.
+ */
+struct LoadContentionModel : public LogPSwitch::ContentionModel
+{
+ public:
+  SST_ELI_REGISTER_DERIVED(
+    LogPSwitch::ContentionModel,
+    LoadContentionModel,
+    "macro",
+    "load",
+    SST_ELI_ELEMENT_VERSION(1,0,0),
+    "charges delays from the bytes in flight on each switch's network links")
+
+  LoadContentionModel(SST::Params& params) : LogPSwitch::ContentionModel(params)
+  {
+    SST::Params top_params;
+    top_ = Topology::staticTopology(top_params);
+
+    //not every topology implements endpointToSwitch
+    node_switch_.resize(top_->numNodes());
+    std::vector<Topology::InjectionPort> ports;
+    for (SwitchId sid=0; sid < top_->numSwitches(); ++sid){
+      top_->endpointsConnectedToInjectionSwitch(sid, ports);
+      for (Topology::InjectionPort& p : ports){
+        node_switch_[p.nid] = sid;
+      }
+    }
+
+    num_links_.resize(top_->numSwitches());
+    std::vector<Topology::Connection> conns;
+    for (SwitchId sid=0; sid < top_->numSwitches(); ++sid){
+      top_->connectedOutports(sid, conns);
+      num_links_[sid] = std::max(1, int(conns.size()));
+    }
+    busy_until_.resize(top_->numSwitches());
+  }
+
+  TimeDelta delay(Timestamp start, NetworkMessage* msg, TimeDelta byte_delay) override {
+    int num_hops = top_->numHopsToNode(msg->fromaddr(), msg->toaddr());
+    if (num_hops == 0){
+      return TimeDelta();
+    }
+
+    SwitchId sid = node_switch_[msg->fromaddr()];
+    TimeDelta occupancy = byte_delay * (msg->byteLength() * double(num_hops) / num_links_[sid]);
+    Timestamp& busy = busy_until_[sid];
+    if (busy <= start){
+      busy = start + occupancy;
+      return TimeDelta();
+    } else {
+      TimeDelta wait = busy - start;
+      busy += occupancy;
+      return wait;
+    }
+  }
+
+ private:
+  Topology* top_;
+  std::vector<SwitchId> node_switch_;
+  std::vector<int> num_links_;
+  std::vector<Timestamp> busy_until_;
+};
+
+
 }
 }
 
@@ -84,9 +84,18 @@ class LogPSwitch : public ConnectableComponent
     SST_ELI_DECLARE_DEFAULT_INFO()
     SST_ELI_DECLARE_CTOR(SST::Params&)
 
-    virtual double value() = 0;
+    /**
+     * @brief delay
+     * @param start The time the message enters the network
+     * @param msg
+     * @param byte_delay The inverse bandwidth of a network link
+     * @return The extra delay to add on top of the LogP estimate
+     */
+    virtual TimeDelta delay(Timestamp start, NetworkMessage* msg, TimeDelta byte_delay) = 0;
 
     ContentionModel(SST::Params&){}
+
+    virtual ~ContentionModel(){}
   };
 
  public:
@@ -142,7 +151,7 @@ class LogPSwitch : public ConnectableComponent
 
   std::vector<EventLink::ptr> nic_links_;
 
-  RNG::MWC* rng_;
+  bool random_noise_;
 
   ContentionModel* contention_model_;
 
@@ -0,0 +1,140 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+
+#include <sstmac/hardware/nic/hot_region.h>
+#include <sstmac/hardware/topology/topology.h>
+#include <sstmac/hardware/topology/dragonfly.h>
+#include <sstmac/hardware/topology/dragonfly_plus.h>
+#include <sstmac/hardware/topology/cascade.h>
+#include <sprockit/sim_parameters.h>
+#include <sprockit/errors.h>
+
+namespace sstmac {
+namespace hw {
+
+HotRegion::HotRegion(SST::Params& params, Topology* top)
+{
+  std::vector<bool> hot_switches(top->numSwitches(), false);
+  bool spatial = false;
+
+  if (params.contains("switches")){
+    std::vector<int> switches;
+    params.find_array("switches", switches);
+    for (int sid : switches){
+      if (sid < 0 || sid >= top->numSwitches()){
+        spkt_abort_printf("hot_region switch %d is out of range [0,%d)",
+                          sid, int(top->numSwitches()));
+      }
+      hot_switches[sid] = true;
+    }
+    spatial = true;
+  }
+
+  if (params.contains("groups")){
+    std::vector<int> groups;
+    params.find_array("groups", groups);
+    for (int g : groups){
+      addGroup(g, top, hot_switches);
+    }
+    spatial = true;
+  }
+
+  if (spatial){
+    hot_nodes_.resize(top->numNodes(), false);
+    std::vector<Topology::InjectionPort> ports;
+    for (SwitchId sid=0; sid < top->numSwitches(); ++sid){
+      if (!hot_switches[sid]) continue;
+      top->endpointsConnectedToInjectionSwitch(sid, ports);
+      for (Topology::InjectionPort& p : ports){
+        hot_nodes_[p.nid] = true;
+      }
+    }
+  }
+
+  if (params.contains("start") || params.contains("stop")){
+    std::vector<std::string> starts;
+    std::vector<std::string> stops;
+    params.find_array("start", starts);
+    params.find_array("stop", stops);
+    if (starts.size() != stops.size()){
+      spkt_abort_printf("hot_region has %d start times, but %d stop times",
+                        int(starts.size()), int(stops.size()));
+    }
+    for (int i=0; i < starts.size(); ++i){
+      Timestamp start(SST::UnitAlgebra(starts[i]).getValue().toDouble());
+      Timestamp stop(SST::UnitAlgebra(stops[i]).getValue().toDouble());
+      if (stop <= start){
+        spkt_abort_printf("hot_region window %s-%s is empty",
+                          starts[i].c_str(), stops[i].c_str());
+      }
+      windows_.emplace_back(start, stop);
+    }
+  }
+}
+
+void
+HotRegion::addGroup(int group, Topology* top, std::vector<bool>& hot_switches)
+{
+  //dragonfly+ derives from dragonfly but numbers its switches differently
+  auto* dfp = dynamic_cast<DragonflyPlus*>(top);
+  auto* dfly = dynamic_cast<Dragonfly*>(top);
+  auto* cascade = dynamic_cast<Cascade*>(top);
+  int num_groups = dfp ? dfp->g() : dfly ? dfly->g() : cascade ? cascade->numG() : 0;
+  if (num_groups == 0){
+    spkt_abort_printf("hot_region groups are only valid for dragonfly, dragonfly_plus, "
+                      "and cascade topologies - list switches instead");
+  }
+  if (group < 0 || group >= num_groups){
+    spkt_abort_printf("hot_region group %d is out of range [0,%d)", group, num_groups);
+  }
+
+  for (SwitchId sid=0; sid < top->numSwitches(); ++sid){
+    int g = dfp ? dfp->computeG(sid) : dfly ? dfly->computeG(sid) : cascade->computeG(sid);
+    if (g == group) hot_switches[sid] = true;
+  }
+}
+
+}
+}
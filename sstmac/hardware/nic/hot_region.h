@@ -0,0 +1,101 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+
+#ifndef SSTMAC_HARDWARE_NIC_HOT_REGION_H
+#define SSTMAC_HARDWARE_NIC_HOT_REGION_H
+
+#include <sstmac/common/timestamp.h>
+#include <sstmac/common/node_address.h>
+#include <sstmac/hardware/topology/topology_fwd.h>
+#include <sprockit/sim_parameters_fwd.h>
+
+#include <vector>
+#include <utility>
+
+namespace sstmac {
+namespace hw {
+
+/**
+ * @brief The HotRegion class selects which traffic a packet-level NIC
+ * actually simulates at packet fidelity. Everything else is sent over
+ * the LogP overlay network. A message is hot if either endpoint hangs
+ * off a hot switch and it is injected inside one of the time windows.
+ * The decision is made once per injection for the whole path, so a
+ * message never changes fidelity midway between source and destination.
+ */
+class HotRegion
+{
+ public:
+  HotRegion(SST::Params& params, Topology* top);
+
+  bool contains(NodeId src, NodeId dst, Timestamp now) const {
+    if (!hot_nodes_.empty() && !hot_nodes_[src] && !hot_nodes_[dst]){
+      return false;
+    }
+    if (windows_.empty()){
+      return true;
+    }
+    for (auto& w : windows_){
+      if (w.first <= now && now < w.second){
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  void addGroup(int group, Topology* top, std::vector<bool>& hot_switches);
+
+  /** Indexed by node. Empty if every node is spatially hot. */
+  std::vector<bool> hot_nodes_;
+
+  /** Injection time windows [start,stop). Empty means always. */
+  std::vector<std::pair<Timestamp,Timestamp>> windows_;
+};
+
+}
+}
+
+#endif // SSTMAC_HARDWARE_NIC_HOT_REGION_H
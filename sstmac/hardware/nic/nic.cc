@@ -43,6 +43,7 @@ Questions? Contact sst-macro-help@sandia.gov
 */
 
 #include <sstmac/hardware/nic/nic.h>
+#include <sstmac/hardware/nic/hot_region.h>
 #include <sstmac/hardware/interconnect/interconnect.h>
 #include <sstmac/hardware/network/network_message.h>
 #include <sstmac/hardware/node/node.h>
@@ -61,12 +62,16 @@ Questions? Contact sst-macro-help@sandia.gov
 RegisterDebugSlot(nic);
 
 RegisterNamespaces("nic", "message_sizes", "traffic_matrix",
-                   "message_size_histogram", "injection", "bytes");
+                   "message_size_histogram", "injection", "bytes", "hot_region");
 
 RegisterKeywords(
 { "nic_name", "DEPRECATED: the type of NIC to use on the node" },
 { "network_spyplot", "DEPRECATED: the file root of all stats showing traffic matrix" },
 { "post_latency", "the latency of the NIC posting messages" },
+{ "switches", "hot_region: switches whose attached nodes are simulated at packet level" },
+{ "groups", "hot_region: dragonfly/cascade groups whose nodes are simulated at packet level" },
+{ "start", "hot_region: start times of windows in which traffic is simulated at packet level" },
+{ "stop", "hot_region: stop times of windows in which traffic is simulated at packet level" },
 );
 
 #define DEFAULT_NEGLIGIBLE_SIZE 256
@@ -75,6 +80,7 @@ namespace sstmac {
 namespace hw {
 
 static sprockit::NeedDeletestatics<NIC> del_statics;
+HotRegion* NIC::hot_region_ = nullptr;
 
 void
 NicEvent::serialize_order(serializer &ser)
@@ -90,6 +96,46 @@ NicEvent::validate_serialization(serializable *ser)
   auto* nev = spkt_assert_ser_type(ser,NicEvent);
   msg_->validate_serialization(nev->msg());
 }
+
+static IpcWire::Registration nic_event_wire(IpcWire::NicEvent, &NicEvent::unpackWire);
+
+uint32_t
+NicEvent::msgWireSize() const
+{
+  NetworkMessage* msg = msg_;
+  serializer ser;
+  ser.start_sizing();
+  ser & msg;
+  return ser.size();
+}
+
+size_t
+NicEvent::ipcWireSize() const
+{
+  return sizeof(WireFormat) + msgWireSize();
+}
+
+void
+NicEvent::packWire(char* buf) const
+{
+  WireFormat* wire = reinterpret_cast<WireFormat*>(buf);
+  wire->msg_bytes = msgWireSize();
+  NetworkMessage* msg = msg_;
+  serializer ser;
+  ser.start_packing(buf + sizeof(WireFormat), wire->msg_bytes);
+  ser & msg;
+}
+
+Event*
+NicEvent::unpackWire(const char* buf)
+{
+  const WireFormat* wire = reinterpret_cast<const WireFormat*>(buf);
+  NicEvent* ev = new NicEvent;
+  serializer ser;
+  ser.start_unpacking(const_cast<char*>(buf) + sizeof(WireFormat), wire->msg_bytes);
+  ser & ev->msg_;
+  return ev;
+}
 #endif
 
 NIC::NIC(uint32_t id, SST::Params& params, Node* parent) :
@@ -97,6 +143,7 @@ NIC::NIC(uint32_t id, SST::Params& params, Node* parent) :
   parent_(parent), 
   my_addr_(parent->addr()),
   logp_link_(nullptr),
+  hot_(nullptr),
   spy_bytes_(nullptr),
   xmit_flows_(nullptr),
   queue_(parent->os()),
@@ -105,6 +152,16 @@ NIC::NIC(uint32_t id, SST::Params& params, Node* parent) :
   negligibleSize_ = params.find<int>("negligible_size", DEFAULT_NEGLIGIBLE_SIZE);
   top_ = Topology::staticTopology(params);
 
+  SST::Params hot_params = params.find_scoped_params("hot_region");
+  if (hot_params.contains("switches") || hot_params.contains("groups")
+      || hot_params.contains("start")){
+    //every NIC shares the same node mask, build it once
+    if (!hot_region_){
+      hot_region_ = new HotRegion(hot_params, top_);
+    }
+    hot_ = hot_region_;
+  }
+
   std::string subname = sprockit::sprintf("NIC.%d", my_addr_);
   auto* spy = registerMultiStatistic<int,uint64_t>(params, "spy_bytes", subname);
   //this might be a null statistic, dynamic cast to check
@@ -138,6 +195,8 @@ NIC::mtlHandle(Event *ev)
 void
 NIC::deleteStatics()
 {
+  if (hot_region_) delete hot_region_;
+  hot_region_ = nullptr;
 }
 
 std::function<void(NetworkMessage*)>
@@ -283,6 +342,12 @@ NIC::recordMessage(NetworkMessage* netmsg)
   xmit_flows_->addData(netmsg->byteLength());
 }
 
+bool
+NIC::hot(NetworkMessage* netmsg) const
+{
+  return !hot_ || hot_->contains(netmsg->fromaddr(), netmsg->toaddr(), now());
+}
+
 void
 NIC::internodeSend(NetworkMessage* netmsg)
 {
@@ -290,7 +355,7 @@ NIC::internodeSend(NetworkMessage* netmsg)
   nic_debug("internode send payload %llu of size %d %s",
     netmsg->flowId(), int(netmsg->byteLength()), netmsg->toString().c_str());
   //we might not have a logp overlay network
-  if (negligibleSize(netmsg->byteLength())){
+  if (negligibleSize(netmsg->byteLength()) || !hot(netmsg)){
     sendManagerMsg(netmsg);
   } else {
     doSend(netmsg);
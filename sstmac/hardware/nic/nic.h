@@ -46,7 +46,9 @@ Questions? Contact sst-macro-help@sandia.gov
 #define SSTMAC_BACKENDS_NATIVE_COMPONENTS_NIC_NETWORKINTERFACE_H_INCLUDED
 
 #include <sstmac/common/timestamp.h>
+#include <sstmac/common/ipc_event.h>
 #include <sstmac/hardware/node/node_fwd.h>
+#include <sstmac/hardware/nic/nic_fwd.h>
 #include <sstmac/hardware/common/failable.h>
 #include <sstmac/hardware/common/connection.h>
 #include <sstmac/hardware/common/packet_fwd.h>
@@ -88,11 +90,32 @@ class NicEvent :
 
 #if !SSTMAC_INTEGRATED_SST_CORE
   void validate_serialization(serializable* ser) override;
+
+  uint32_t ipcWireType() const override {
+    return IpcWire::NicEvent;
+  }
+
+  size_t ipcWireSize() const override;
+
+  void packWire(char* buf) const override;
+
+  static Event* unpackWire(const char* buf);
 #endif
 
   void serialize_order(serializer& ser) override;
 
  private:
+#if !SSTMAC_INTEGRATED_SST_CORE
+  /**
+   * Only the message is serialized, without the class lookup for the event itself
+   */
+  struct WireFormat {
+    uint64_t msg_bytes;
+  };
+
+  uint32_t msgWireSize() const;
+#endif
+
   NicEvent(){} //for serialization
 
   NetworkMessage* msg_;
@@ -206,13 +229,24 @@ class NIC : public ConnectableSubcomponent
     return bytes <= negligibleSize_;
   }
 
+  /**
+   * @brief hot
+   * @param msg
+   * @return Whether the message should be simulated at packet level.
+   *         Cold messages travel over the LogP overlay network instead.
+   */
+  bool hot(NetworkMessage* msg) const;
+
   int negligibleSize_;
   Node* parent_;
   NodeId my_addr_;
   EventLink::ptr logp_link_;
   Topology* top_;
+  HotRegion* hot_;
 
  private:
+  static HotRegion* hot_region_;
+
   StatSpyplot<int,uint64_t>* spy_bytes_;
   Statistic<uint64_t>* xmit_flows_;
   sw::SingleProgressQueue<NetworkMessage> queue_;
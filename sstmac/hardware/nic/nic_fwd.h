@@ -49,6 +49,7 @@ namespace sstmac {
 namespace hw {
 
 class NIC;
+class HotRegion;
 
 }
 }
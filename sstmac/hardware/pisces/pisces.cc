@@ -44,6 +44,8 @@ Questions? Contact sst-macro-help@sandia.gov
 
 #include <sstmac/hardware/pisces/pisces.h>
 
+#include <cstring>
+
 RegisterDebugSlot(pisces,
     "print all the details of the pisces model including crossbar arbitration"
     ", buffer occupancies, and queue depths. This can be a LOT of information. User beware")
@@ -105,6 +107,60 @@ PiscesCredit::serialize_order(serializer& ser)
   ser & port_;
   ser & vc_;
 }
+#if !SSTMAC_INTEGRATED_SST_CORE
+static IpcWire::Registration pisces_packet_wire(IpcWire::PiscesPacket, &PiscesPacket::unpackWire);
+static IpcWire::Registration pisces_credit_wire(IpcWire::PiscesCredit, &PiscesCredit::unpackWire);
+
+size_t
+PiscesPacket::ipcWireSize() const
+{
+  return sizeof(WireFormat) + payloadWireSize();
+}
+
+void
+PiscesPacket::packWire(char* buf) const
+{
+  WireFormat* wire = reinterpret_cast<WireFormat*>(buf);
+  packWireFields(wire->packet, buf + sizeof(WireFormat), payloadWireSize());
+  wire->byte_delay = byte_delay_;
+  wire->arrival = arrival_;
+  wire->current_vc = current_vc_;
+  wire->stage = stage_;
+  ::memcpy(wire->outports, outports_, sizeof(outports_));
+  wire->inport = inport_;
+}
+
+Event*
+PiscesPacket::unpackWire(const char* buf)
+{
+  const WireFormat* wire = reinterpret_cast<const WireFormat*>(buf);
+  PiscesPacket* pkt = new PiscesPacket;
+  pkt->unpackWireFields(wire->packet, buf + sizeof(WireFormat));
+  pkt->byte_delay_ = wire->byte_delay;
+  pkt->arrival_ = wire->arrival;
+  pkt->current_vc_ = wire->current_vc;
+  pkt->stage_ = wire->stage;
+  ::memcpy(pkt->outports_, wire->outports, sizeof(pkt->outports_));
+  pkt->inport_ = wire->inport;
+  return pkt;
+}
+
+void
+PiscesCredit::packWire(char* buf) const
+{
+  WireFormat* wire = reinterpret_cast<WireFormat*>(buf);
+  wire->num_credits = num_credits_;
+  wire->port = port_;
+  wire->vc = vc_;
+}
+
+Event*
+PiscesCredit::unpackWire(const char* buf)
+{
+  const WireFormat* wire = reinterpret_cast<const WireFormat*>(buf);
+  return new PiscesCredit(wire->port, wire->vc, wire->num_credits);
+}
+#endif
 
 }
 }
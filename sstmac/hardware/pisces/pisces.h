@@ -47,6 +47,7 @@ Questions? Contact sst-macro-help@sandia.gov
 
 #include <sstmac/hardware/common/packet.h>
 #include <sstmac/hardware/common/flow.h>
+#include <sstmac/common/ipc_event.h>
 #include <sprockit/thread_safe_new.h>
 #include <sprockit/factory.h>
 #include <sprockit/debug.h>
@@ -170,7 +171,31 @@ class PiscesPacket :
 
   void serialize_order(serializer& ser) override;
 
+#if !SSTMAC_INTEGRATED_SST_CORE
+  uint32_t ipcWireType() const override {
+    return IpcWire::PiscesPacket;
+  }
+
+  size_t ipcWireSize() const override;
+
+  void packWire(char* buf) const override;
+
+  static Event* unpackWire(const char* buf);
+#endif
+
  private:
+#if !SSTMAC_INTEGRATED_SST_CORE
+  struct WireFormat {
+    Packet::WireFields packet;
+    TimeDelta byte_delay;
+    Timestamp arrival;
+    int32_t current_vc;
+    uint8_t stage;
+    uint8_t outports[3];
+    uint16_t inport;
+  };
+#endif
+
   PiscesPacket(){} //for serialization
 
   TimeDelta byte_delay_;
@@ -227,7 +252,29 @@ class PiscesCredit :
 
   void serialize_order(serializer& ser) override;
 
+#if !SSTMAC_INTEGRATED_SST_CORE
+  uint32_t ipcWireType() const override {
+    return IpcWire::PiscesCredit;
+  }
+
+  size_t ipcWireSize() const override {
+    return sizeof(WireFormat);
+  }
+
+  void packWire(char* buf) const override;
+
+  static Event* unpackWire(const char* buf);
+#endif
+
  protected:
+#if !SSTMAC_INTEGRATED_SST_CORE
+  struct WireFormat {
+    int32_t num_credits;
+    int32_t port;
+    int32_t vc;
+  };
+#endif
+
   int num_credits_;
   int port_;
   int vc_;
@@ -156,11 +156,11 @@ PiscesNullArbitrator::arbitrate(IncomingPacket &st)
 PiscesCutThroughArbitrator::
 PiscesCutThroughArbitrator(double bw)
   : PiscesBandwidthArbitrator(bw),
-    head_(nullptr)
+    first_(0),
+    numEpochs_(1)
 {
   cycleLength_ = byteDelay_;
-  head_ = Epoch::allocateAtBeginning();
-  head_->numCycles = std::numeric_limits<uint32_t>::max();
+  epochs_[0].numCycles = std::numeric_limits<uint32_t>::max();
 }
 
 
@@ -172,25 +172,19 @@ PiscesCutThroughArbitrator::headTailDelay(PiscesPacket *pkt)
 
 PiscesCutThroughArbitrator::~PiscesCutThroughArbitrator()
 {
-  auto* next = head_;
-  while (next) {
-    auto* toDel = next;
-    next = next->next;
-    Epoch::freeAtEnd(toDel);
-  }
 }
 
 void
 PiscesCutThroughArbitrator::clearOut(Timestamp now)
 {
-  Epoch* epoch = head_;
-  while (epoch){
+  while (true){
+    Epoch* epoch = &epochAt(0);
     cut_through_epoch_debug("clearing at %9.5e", now.sec());
     Timestamp end = epoch->start + epoch->numCycles * cycleLength_;
     if (now <= epoch->start){
       return;
     } else if (now < end){
-      if (epoch->next){
+      if (numEpochs_ > 1){
         TimeDelta lostTime = now - epoch->start;
         uint32_t lostCycles = lostTime / cycleLength_;
         epoch->numCycles -= lostCycles;
@@ -200,30 +194,76 @@ PiscesCutThroughArbitrator::clearOut(Timestamp now)
       }
       epoch->start = now;
       return;
+    } else if (numEpochs_ > 1){
+      removeEpoch(0);
     } else {
-      if (epoch->next){
-        Epoch* next = epoch->next;
-        delete epoch;
-        head_ = next;
-        epoch = next;
-      } else {
-        //this is the last epoch - restore it to "full size"
-        epoch->numCycles = std::numeric_limits<uint32_t>::max();
-        epoch->start = now;
-        return;
-      }
+      //this is the last epoch - restore it to "full size"
+      epoch->numCycles = std::numeric_limits<uint32_t>::max();
+      epoch->start = now;
+      return;
     }
   }
 }
 
-PiscesCutThroughArbitrator::Epoch*
-PiscesCutThroughArbitrator::advance(Epoch* epoch, Epoch* prev)
+void
+PiscesCutThroughArbitrator::removeEpoch(int idx)
 {
-  Epoch* next = epoch->next;
-  if (prev) prev->next = epoch->next;
-  else head_ = next;
-  delete epoch;
-  return next;
+  //shift whichever side of the ring is shorter
+  if (idx < numEpochs_ / 2){
+    for (int i=idx; i > 0; --i){
+      epochAt(i) = epochAt(i-1);
+    }
+    first_ = (first_ + 1) & (maxEpochs-1);
+  } else {
+    for (int i=idx; i < numEpochs_ - 1; ++i){
+      epochAt(i) = epochAt(i+1);
+    }
+  }
+  --numEpochs_;
+}
+
+int
+PiscesCutThroughArbitrator::insertEpoch(int idx, const Epoch& ep)
+{
+  if (numEpochs_ == maxEpochs){
+    idx = coalesce(idx);
+  }
+  if (idx < numEpochs_ / 2){
+    first_ = (first_ + maxEpochs - 1) & (maxEpochs-1);
+    for (int i=0; i < idx; ++i){
+      epochAt(i) = epochAt(i+1);
+    }
+  } else {
+    for (int i=numEpochs_; i > idx; --i){
+      epochAt(i) = epochAt(i-1);
+    }
+  }
+  epochAt(idx) = ep;
+  ++numEpochs_;
+  return idx;
+}
+
+int
+PiscesCutThroughArbitrator::coalesce(int keep)
+{
+  //merge the pair of finite epochs with the smallest gap between them,
+  //leaving alone the epoch being split just before the insert position
+  int best = -1;
+  TimeDelta bestGap;
+  for (int i=0; i < numEpochs_ - 2; ++i){
+    if (i == keep - 2 || i == keep - 1){
+      continue;
+    }
+    Epoch& ep = epochAt(i);
+    TimeDelta gap = epochAt(i+1).start - (ep.start + ep.numCycles * cycleLength_);
+    if (best < 0 || gap < bestGap){
+      best = i;
+      bestGap = gap;
+    }
+  }
+  epochAt(best).numCycles += epochAt(best+1).numCycles;
+  removeEpoch(best+1);
+  return best < keep ? keep - 1 : keep;
 }
 
 void
@@ -237,10 +277,8 @@ PiscesCutThroughArbitrator::arbitrate(IncomingPacket &st)
 #define PRINT_EPOCHS 0
 #if PRINT_EPOCHS
   std::cout << "------" << std::endl;
-  Epoch* start_ep = head_;
-  while(start_ep){
-    std::cout << "Start epoch " << this << ": " << start_ep->start.time.ticks() << ": " << start_ep->numCycles << std::endl;
-    start_ep = start_ep->next;
+  for (int i=0; i < numEpochs_; ++i){
+    std::cout << "Start epoch " << this << ": " << epochAt(i).start.time.ticks() << ": " << epochAt(i).numCycles << std::endl;
   }
   std::cout << "------" << std::endl;
 #endif
@@ -248,18 +286,28 @@ PiscesCutThroughArbitrator::arbitrate(IncomingPacket &st)
   clearOut(st.now);
 
   Timestamp fullyBufferedTime = st.now + st.pkt->byteDelay() * st.pkt->numBytes();
-  Epoch* epoch = head_;
-  Epoch* prev = nullptr;
+  int idx = 0;
   uint32_t bytesSent = 0;
   uint32_t bytesLeft = st.pkt->numBytes();
   //first idle epoch
-  st.head_leaves = epoch->start;
+  st.head_leaves = epochAt(0).start;
+  if (numEpochs_ == 1 && bytesLeft > 2
+      && (st.pkt->byteDelay() <= cycleLength_ || fullyBufferedTime <= epochAt(0).start)){
+    //the link is idle from head_leaves onward and the packet never waits on
+    //its own bytes arriving: it goes out back-to-back
+    Epoch& ep = epochAt(0);
+    ep.start += bytesLeft * cycleLength_;
+    ep.numCycles -= bytesLeft;
+    st.tail_leaves = ep.start;
+    bytesLeft = 0;
+  }
   while (bytesLeft > 2){ //we often end up with 1,2 byte stragglers - ignore them for efficiency
 #if SSTMAC_SANITY_CHECK
-    if (!epoch){
+    if (idx >= numEpochs_){
       spkt_abort_printf("ran out of epochs on arbitrator %p: this should not be possible", this);
     }
 #endif
+    Epoch* epoch = &epochAt(idx);
     TimeDelta epochLength = epoch->numCycles * cycleLength_;
     Timestamp epochEnd = epoch->start + epochLength;
     if (st.pkt->byteDelay() <= cycleLength_){
@@ -269,7 +317,7 @@ PiscesCutThroughArbitrator::arbitrate(IncomingPacket &st)
         //epoch is completely busy
         bytesSent += epoch->numCycles;
         bytesLeft -= epoch->numCycles;
-        epoch = advance(epoch, prev);
+        removeEpoch(idx);
         st.tail_leaves = epochEnd;
       } else {
         //epoch has to split into busy and idle halves
@@ -289,12 +337,11 @@ PiscesCutThroughArbitrator::arbitrate(IncomingPacket &st)
           cut_through_arb_debug_noargs("buffering finishes after epoch: epoch used up");
           bytesSent += epoch->numCycles;
           bytesLeft -= epoch->numCycles;
-          epoch = advance(epoch, prev);
+          removeEpoch(idx);
         } else {
           cut_through_arb_debug_noargs("buffering finishes after epoch: epoch has leftover cycles");
           epoch->numCycles -= bytesBuffered;
-          prev = epoch;
-          epoch = epoch->next;
+          ++idx;
           bytesSent += bytesBuffered;
           bytesLeft -= bytesBuffered;
         }
@@ -314,30 +361,23 @@ PiscesCutThroughArbitrator::arbitrate(IncomingPacket &st)
           bytesLeft -= epoch->numCycles;
           bytesSent += epoch->numCycles;
           //epoch is used up
-          epoch = advance(epoch, prev);
+          removeEpoch(idx);
           st.tail_leaves = epochEnd;
         }
       } else {
         //buffering finishes in the middle of the epoch
         //split the epochs on buffering finishing and repeat
-        Epoch* next = new Epoch;
         TimeDelta deltaT = fullyBufferedTime - epoch->start;
         uint32_t preCycles = deltaT  / cycleLength_;
         uint32_t postCycles = epoch->numCycles - preCycles;
         cut_through_arb_debug("buffering finishes during epoch: pre=%u post=%u",
                               preCycles, postCycles);
+        Epoch next;
+        next.start = epoch->start + deltaT;
+        //if this is the last epoch, replenish the cycles
+        next.numCycles = idx + 1 < numEpochs_ ? postCycles : std::numeric_limits<uint32_t>::max();
         epoch->numCycles = preCycles;
-        if (epoch->next){
-          //there are more epochs after this
-          next->next = epoch->next;
-          next->numCycles = postCycles;
-        } else {
-          next->next = nullptr;
-          //oh, this is the last epoch - replenish the cycles
-          next->numCycles = std::numeric_limits<uint32_t>::max();
-        }
-        next->start = epoch->start + deltaT;
-        epoch->next = next;
+        idx = insertEpoch(idx + 1, next) - 1;
       }
     }
   }
@@ -346,22 +386,18 @@ PiscesCutThroughArbitrator::arbitrate(IncomingPacket &st)
   st.pkt->setByteDelay(newByteDelay);
 
 #if SSTMAC_SANITY_CHECK
-  Epoch* end_ep = head_;
   Timestamp end_last;
-  while(end_ep){
+  for (int i=0; i < numEpochs_; ++i){
 #if PRINT_EPOCHS
-    std::cout << "End epoch " << this << ": " << end_ep->start.time.ticks() << ": " << end_ep->numCycles << std::endl;
+    std::cout << "End epoch " << this << ": " << epochAt(i).start.time.ticks() << ": " << epochAt(i).numCycles << std::endl;
 #endif
-    if (end_last > end_ep->start){
-      Epoch* test = head_;
-      while (test){
-        std::cerr << "Epoch " << test->start.time.ticks() << ": " << test->numCycles << std::endl;
-        test = test->next;
+    if (end_last > epochAt(i).start){
+      for (int j=0; j < numEpochs_; ++j){
+        std::cerr << "Epoch " << epochAt(j).start.time.ticks() << ": " << epochAt(j).numCycles << std::endl;
       }
       spkt_abort_printf("arbitration epochs go backward in time");
     }
-    end_last = end_ep->start;
-    end_ep = end_ep->next;
+    end_last = epochAt(i).start;
   }
 #endif
 
@@ -200,19 +200,34 @@ class PiscesCutThroughArbitrator :
   TimeDelta headTailDelay(PiscesPacket *pkt) override;
 
  private:
-  struct Epoch : public sprockit::thread_safe_new<Epoch> {
+  /** An idle window on the link with numCycles free byte cycles from start */
+  struct Epoch {
     Timestamp start;
     uint32_t numCycles;
-    Epoch* next;
   };
 
-  Epoch* advance(Epoch* epoch, Epoch* prev);
+  /** Idle epochs live in a fixed ring of slots. When it fills up,
+   *  the two adjacent epochs separated by the smallest gap are merged. */
+  static constexpr int maxEpochs = 64;
+  static_assert(maxEpochs >= 8 && (maxEpochs & (maxEpochs-1)) == 0,
+                "epoch ring must leave pairs to coalesce and be a power of 2");
+
+  Epoch& epochAt(int idx){
+    return epochs_[(first_ + idx) & (maxEpochs-1)];
+  }
 
   void clearOut(Timestamp now);
 
-  Epoch* head_;
+  void removeEpoch(int idx);
+
+  int insertEpoch(int idx, const Epoch& ep);
+
+  int coalesce(int keep);
+
+  Epoch epochs_[maxEpochs];
+  int first_;
+  int numEpochs_;
   TimeDelta cycleLength_;
-  Timestamp lastEpochEnd_;
 
 };
 
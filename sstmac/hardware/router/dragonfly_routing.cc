@@ -124,12 +124,15 @@ struct DragonflyMinimalRouter : public Router {
       }
     }
 
+    int max_ports = 1;
     for (int i=0; i < group_ports_.size(); ++i){
       if (!group_ports_[i].empty()){
         group_port_rotaters_[i] = my_addr_ % group_ports_[i].size();
+        max_ports = std::max(max_ports, int(group_ports_[i].size()));
       }
     }
 
+    next_hops_.init(dfly_->numSwitches(), max_ports, next_hop_budget_);
   }
 
   int numVC() const override {
@@ -154,10 +157,62 @@ struct DragonflyMinimalRouter : public Router {
     routeToSwitch(pkt, ejaddr);
   }
 
+  /**
+   * @brief minimalHop Fill the next hop row for a destination switch.
+   * Intra-group rows hold the direct port, inter-group rows hold every
+   * port toward the group. The tag is the destination group.
+   */
+  void minimalHop(SwitchId ej_addr, NextHopTable::Row& hop)
+  {
+    int dstG = dfly_->computeG(ej_addr);
+    if (dstG == my_g_){
+      hop.addPort(dfly_->computeA(ej_addr));
+    } else {
+      for (int port : group_ports_[dstG]){
+        if (port >= (dfly_->a() + dfly_->h())){
+          spkt_abort_printf("Got bad group port %d going to group %d from switch=(%d,%d)",
+                            port, dstG, my_a_, my_g_);
+        }
+        hop.addPort(port);
+      }
+    }
+    hop.setTag(dstG);
+  }
+
   void routeToSwitch(Packet* pkt, SwitchId ej_addr)
   {
     auto hdr = pkt->rtrHeader<header>();
     hdr->deadlock_vc = hdr->num_group_hops;
+    if (!next_hops_.active()){
+      routeToSwitchDirect(pkt, ej_addr);
+      return;
+    }
+
+    auto hop = next_hops_.row(ej_addr);
+    if (hop.empty()){
+      minimalHop(ej_addr, hop);
+    }
+    int dstG = hop.tag();
+    if (dstG == my_g_){
+      hdr->edge_port = hop.port(0);
+    } else {
+      int dst_port;
+      if (static_route_){
+        dst_port = hop.port(ej_addr % hop.size());
+      } else {
+        dst_port = hop.port(group_port_rotaters_[dstG]);
+        group_port_rotaters_[dstG] = (group_port_rotaters_[dstG] + 1) % hop.size();
+      }
+      if (dst_port >= dfly_->a()){
+        hdr->num_group_hops++;
+      }
+      hdr->edge_port = dst_port;
+    }
+  }
+
+  void routeToSwitchDirect(Packet* pkt, SwitchId ej_addr)
+  {
+    auto hdr = pkt->rtrHeader<header>();
     int dstG = dfly_->computeG(ej_addr);
     if (dstG == my_g_){
       int dstA = dfly_->computeA(ej_addr);
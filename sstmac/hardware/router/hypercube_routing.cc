@@ -72,6 +72,8 @@ class HypercubeMinimalRouter : public Router {
     for (int size : cube_->dimensions()){
       inj_offset_ += size;
     }
+    //every minimal hop is a single port
+    next_hops_.init(cube_->numSwitches(), 1, next_hop_budget_);
   }
 
   std::string toString() const override {
@@ -91,11 +93,24 @@ class HypercubeMinimalRouter : public Router {
       return;
     }
 
-    cube_->minimalRouteToSwitch(my_addr_, ej_addr, hdr);
+    minimalRoute(ej_addr, hdr);
     hdr->deadlock_vc = 0;
   }
 
  protected:
+  void minimalRoute(SwitchId dst, Packet::Header* hdr){
+    if (next_hops_.active()){
+      auto hop = next_hops_.row(dst);
+      if (hop.empty()){
+        cube_->minimalRouteToSwitch(my_addr_, dst, hdr);
+        hop.addPort(hdr->edge_port);
+      }
+      hdr->edge_port = hop.port(0);
+    } else {
+      cube_->minimalRouteToSwitch(my_addr_, dst, hdr);
+    }
+  }
+
   Hypercube* cube_;
   int inj_offset_;
 };
@@ -231,34 +246,21 @@ class HypercubeParRouter : public HypercubeMinimalRouter {
     }
     case valiant_stage: {
       if (my_addr_ != hdr->dest_switch){
-        auto coords = cube_->switchCoords(hdr->dest_switch);
-        if (coords[0] != myX_){
-          hdr->edge_port = coords[0];
-        } else if (coords[1] != myY_){
-          hdr->edge_port = coords[1]+x_;
-        } else {
-          hdr->edge_port = coords[2]+x_+y_;
-        }
+        minimalRoute(hdr->dest_switch, hdr);
         break;
       }
       hdr->stage_number = final_stage;
       //otherwise fall through
     }
     case final_stage: {
-      int port;
-      if (hdr->dstX != myX_){
-        port = hdr->dstX;
-      } else if (hdr->dstY != myY_){
-        port = hdr->dstY+x_;
-      } else if (hdr->dstZ != myZ_) {
-        port = hdr->dstZ+x_+y_;
-      } else {
+      SwitchId ej_addr = pkt->toaddr() / cube_->concentration();
+      if (ej_addr == my_addr_){
         //oh - um - eject
        hdr->edge_port = hdr->ejPort;
        hdr->deadlock_vc = 0;
        return;
       }
-      hdr->edge_port = port;
+      minimalRoute(ej_addr, hdr);
     }
     }
 
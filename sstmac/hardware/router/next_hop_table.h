@@ -0,0 +1,148 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+
+#ifndef SSTMAC_HARDWARE_NETWORK_ROUTING_NEXT_HOP_TABLE_H_INCLUDED
+#define SSTMAC_HARDWARE_NETWORK_ROUTING_NEXT_HOP_TABLE_H_INCLUDED
+
+#include <sstmac/common/node_address.h>
+#include <sprockit/errors.h>
+#include <cstdint>
+#include <vector>
+
+namespace sstmac {
+namespace hw {
+
+/**
+ * @brief A flat per-switch cache of minimal next hops.
+ *  Rows are indexed by destination switch and hold the candidate output ports
+ *  for a minimal path plus a small router-defined tag (a VC rule, a rotater
+ *  group, ...). Rows are filled lazily by the owning router the first time a
+ *  destination is seen. The table is only enabled if a row for every switch
+ *  fits in the memory budget, otherwise routers compute hops directly.
+ */
+class NextHopTable
+{
+ public:
+  class Row {
+   public:
+    bool empty() const {
+      return data_[0] == 0;
+    }
+
+    int size() const {
+      return data_[0];
+    }
+
+    int tag() const {
+      return data_[1];
+    }
+
+    int port(int idx) const {
+      return data_[2+idx];
+    }
+
+    void setTag(int tag){
+      data_[1] = tag;
+    }
+
+    void addPort(int port){
+      if (data_[0] == max_ports_){
+        spkt_abort_printf("next hop table row overflows %d candidate ports", max_ports_);
+      }
+      data_[2+data_[0]] = port;
+      ++data_[0];
+    }
+
+   private:
+    friend class NextHopTable;
+
+    Row(uint16_t* data, int max_ports) :
+      data_(data), max_ports_(max_ports)
+    {
+    }
+
+    uint16_t* data_;
+    int max_ports_;
+  };
+
+  NextHopTable() : stride_(0), max_ports_(0) {}
+
+  /**
+   * @brief init Size the table for every destination switch
+   * @param num_switches  The number of destination switches
+   * @param max_ports     The largest candidate port set in any row
+   * @param budget        The max number of bytes the table may use
+   * @return Whether the table fit in the budget and is active
+   */
+  bool init(int num_switches, int max_ports, uint64_t budget){
+    uint64_t stride = max_ports + 2;
+    uint64_t bytes = stride * num_switches * sizeof(uint16_t);
+    if (max_ports <= 0 || bytes > budget){
+      return false;
+    }
+    stride_ = stride;
+    max_ports_ = max_ports;
+    table_.resize(stride_ * num_switches);
+    return true;
+  }
+
+  bool active() const {
+    return stride_ != 0;
+  }
+
+  Row row(SwitchId dst){
+    return Row(&table_[uint64_t(dst)*stride_], max_ports_);
+  }
+
+ private:
+  std::vector<uint16_t> table_;
+  uint64_t stride_;
+  int max_ports_;
+};
+
+}
+}
+
+#endif
@@ -60,26 +60,24 @@ RegisterNamespaces("router");
 RegisterKeywords(
 { "router", "the type of routing to perform in the network" },
 { "ugal_threshold", "in UGAL, the min number of hops before allowing MIN-UGAL change"},
+{ "next_hop_cache_size", "the max bytes per switch for caching minimal next hops, 0 to disable"},
 );
 
 namespace sstmac {
 namespace hw {
 
 Router::Router(SST::Params& params, Topology *top, NetworkSwitch *sw)
- : top_(top), netsw_(sw), rng_(nullptr), vl_offset_(0)
+ : top_(top), netsw_(sw), num_draws_(0), vl_offset_(0)
 {
   my_addr_ = SwitchId(params.find<int>("id"));
-  std::vector<RNG::rngint_t> seeds(2);
-  seeds[0] = 42;
   if (params.contains("seed")) {
     seed_ = params.find<long>("seed");
-    seeds[1] = seed_;
     debug_seed_ = true;
   } else {
-    seeds[1] = time(NULL);
+    seed_ = time(NULL);
     debug_seed_ = false;
   }
-  rng_ = RNG::MWC::construct(seeds);
+  next_hop_budget_ = params.find<SST::UnitAlgebra>("next_hop_cache_size", "64KB").getRoundedValue();
 }
 
 bool
@@ -103,19 +101,14 @@ Router::switchPaths(
 uint32_t
 Router::randomNumber(uint32_t max, uint32_t attempt, uint32_t seed) const
 {
-  if (debug_seed_){
-    std::vector<RNG::rngint_t> seeds(2);
-    uint32_t time = seed;
-    seeds[1] = seed_ * (time+31) << (attempt + 5);
-    seeds[0] = (time+5)*7 + seeds[0]*attempt*42 + 3;
-    rng_->vec_reseed(seeds);
-  }
-  return rng_->value_in_range(max);
+  //with a fixed seed, the draw depends only on the switch and the arguments
+  //which makes random routing independent of the thread/rank layout
+  uint32_t stream = debug_seed_ ? 0 : num_draws_++;
+  return RNG::Philox::draw(seed_, my_addr_, seed, attempt, stream) % max;
 }
 
 Router::~Router()
 {
-  if (rng_) delete rng_;
 }
 
 class FullyConnectedMinimalRouter : public Router {
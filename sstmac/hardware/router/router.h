@@ -49,6 +49,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/common/node_address.h>
 #include <sstmac/common/event_manager_fwd.h>
 #include <sstmac/hardware/common/packet.h>
+#include <sstmac/hardware/router/next_hop_table.h>
 #include <sstmac/sst_core/integrated_component.h>
 
 #include <sprockit/debug.h>
@@ -124,10 +125,11 @@ class Router : public sprockit::printable
   }
 
   /**
-   * @brief random_number
+   * @brief random_number Draw from a counter-based stream keyed by the router
+   *  seed and switch id. No state is reseeded between calls.
    * @param max     Select number [0,max) exclusive
-   * @param attempt Optional argument to reseed if calling from a loop
-   * @param seed    Optional seed for seeding if in debug mode
+   * @param attempt Distinguishes draws made from inside a loop
+   * @param seed    Counter for the draw, usually the current time
    * @return
    */
   uint32_t randomNumber(uint32_t max, uint32_t attempt, uint32_t seed) const;
@@ -160,10 +162,19 @@ class Router : public sprockit::printable
 
   bool debug_seed_;
 
-  RNG::MWC* rng_;
+  mutable uint32_t num_draws_;
 
   int vl_offset_;
 
+  /**
+   * Cache of minimal next hops by destination switch. Routers that use it
+   * size it with #next_hop_budget_ and fall back to computing hops directly
+   * if it does not fit.
+   */
+  NextHopTable next_hops_;
+
+  uint64_t next_hop_budget_;
+
 };
 
 }
@@ -0,0 +1,308 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+
+#include <sstmac/hardware/router/routing_table.h>
+#include <sstmac/hardware/topology/topology.h>
+#include <sstmac/hardware/topology/file.h>
+#include <sstmac/libraries/nlohmann/json.hpp>
+#include <sprockit/errors.h>
+#include <sprockit/statics.h>
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace sstmac {
+namespace hw {
+
+static const char routing_table_magic[8] = {'S','S','T','M','R','T','B','L'};
+static const uint32_t no_channel = std::numeric_limits<uint32_t>::max();
+static_assert(sizeof(RoutingTable::Header) == 32, "routing table header must not have padding");
+
+static std::mutex tables_lock;
+static std::map<std::string, RoutingTable*> tables;
+static sprockit::NeedDeletestatics<RoutingTable> del_statics;
+
+const RoutingTable*
+RoutingTable::get(const std::string& fname, Topology* top)
+{
+  std::lock_guard<std::mutex> lock(tables_lock);
+  auto iter = tables.find(fname);
+  if (iter != tables.end()){
+    return iter->second;
+  }
+  RoutingTable* table = new RoutingTable(fname, top);
+  tables[fname] = table;
+  return table;
+}
+
+void
+RoutingTable::deleteStatics()
+{
+  for (auto& pair : tables){
+    delete pair.second;
+  }
+  tables.clear();
+}
+
+RoutingTable::RoutingTable(const std::string& fname, Topology* top) :
+  mapped_(nullptr),
+  mapped_size_(0)
+{
+  int fd = ::open(fname.c_str(), O_RDONLY);
+  if (fd < 0){
+    spkt_abort_printf("routing table: failed to open file %s", fname.c_str());
+  }
+
+  char magic[sizeof(routing_table_magic)];
+  ssize_t nread = ::read(fd, magic, sizeof(magic));
+  bool compiled = nread == sizeof(magic)
+      && ::memcmp(magic, routing_table_magic, sizeof(magic)) == 0;
+  if (!compiled){
+    ::close(fd);
+    buildImage(fname, top, owned_);
+    setImage(owned_.data(), owned_.size(), fname, top);
+    return;
+  }
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0){
+    spkt_abort_printf("routing table: failed to stat file %s", fname.c_str());
+  }
+  mapped_size_ = st.st_size;
+  mapped_ = ::mmap(nullptr, mapped_size_, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapped_ == MAP_FAILED){
+    spkt_abort_printf("routing table: failed to map file %s", fname.c_str());
+  }
+  setImage((const char*) mapped_, mapped_size_, fname, top);
+}
+
+RoutingTable::~RoutingTable()
+{
+  if (mapped_) ::munmap(mapped_, mapped_size_);
+}
+
+void
+RoutingTable::setImage(const char* image, size_t size, const std::string& fname,
+                       Topology* top)
+{
+  if (size < sizeof(Header)){
+    spkt_abort_printf("routing table: file %s is truncated", fname.c_str());
+  }
+  const Header* hdr = (const Header*) image;
+  if (hdr->version != version){
+    spkt_abort_printf("routing table: file %s has version %u, expected %u - recompile it",
+                      fname.c_str(), hdr->version, version);
+  }
+  if (hdr->num_switches != top->numSwitches() || hdr->num_nodes != top->numNodes()){
+    spkt_abort_printf("routing table: file %s is for %u switches and %u nodes, "
+                      "but the topology has %d switches and %d nodes",
+                      fname.c_str(), hdr->num_switches, hdr->num_nodes,
+                      int(top->numSwitches()), int(top->numNodes()));
+  }
+
+  num_switches_ = hdr->num_switches;
+  num_nodes_ = hdr->num_nodes;
+  uint64_t num_entries = uint64_t(num_switches_) * num_nodes_;
+  size_t expected = sizeof(Header)
+      + num_entries * sizeof(uint32_t)
+      + (hdr->num_channels + 1) * sizeof(uint32_t)
+      + hdr->num_ports * sizeof(int32_t);
+  if (size != expected){
+    spkt_abort_printf("routing table: file %s has %llu bytes, expected %llu",
+                      fname.c_str(), (unsigned long long) size,
+                      (unsigned long long) expected);
+  }
+
+  channels_ = (const uint32_t*) (image + sizeof(Header));
+  port_offsets_ = channels_ + num_entries;
+  ports_ = (const int32_t*) (port_offsets_ + hdr->num_channels + 1);
+}
+
+bool
+RoutingTable::hasChannels(SwitchId sid) const
+{
+  for (NodeId dst=0; dst < num_nodes_; ++dst){
+    int num_ports;
+    ports(sid, dst, num_ports);
+    if (num_ports > 1) return true;
+  }
+  return false;
+}
+
+void
+RoutingTable::buildImage(const std::string& json_fname, Topology* top,
+                         std::vector<char>& image)
+{
+  std::ifstream in(json_fname);
+  if (in.fail()){
+    spkt_abort_printf("routing table: failed to open file %s", json_fname.c_str());
+  }
+  nlohmann::json jsn;
+  in >> jsn;
+
+  FileTopology* file_topo = dynamic_cast<FileTopology*>(top);
+  uint32_t num_switches = top->numSwitches();
+  uint32_t num_nodes = top->numNodes();
+  std::vector<uint32_t> channels(uint64_t(num_switches) * num_nodes, no_channel);
+  std::vector<uint32_t> port_offsets(1, 0);
+  std::vector<int32_t> ports;
+  std::map<std::vector<int32_t>, uint32_t> channel_ids;
+
+  auto add_channel = [&](const std::vector<int32_t>& chan_ports) -> uint32_t {
+    auto iter = channel_ids.find(chan_ports);
+    if (iter != channel_ids.end()) return iter->second;
+    uint32_t id = port_offsets.size() - 1;
+    ports.insert(ports.end(), chan_ports.begin(), chan_ports.end());
+    port_offsets.push_back(ports.size());
+    channel_ids[chan_ports] = id;
+    return id;
+  };
+
+  const nlohmann::json& switches = jsn.at("switches");
+  for (auto sw = switches.begin(); sw != switches.end(); ++sw){
+    SwitchId sid;
+    try {
+      sid = top->switchNameToId(sw.key());
+    } catch (const sprockit::InputError&) {
+      //routing dumps can list switches that are not part of the simulated topology
+      continue;
+    }
+    if (sid >= num_switches) continue;
+
+    nlohmann::json port_channels;
+    if (file_topo){
+      nlohmann::json switch_ports = file_topo->getSwitchJson(sw.key());
+      auto pch_it = switch_ports.find("port_channels");
+      if (pch_it != switch_ports.end()){
+        port_channels = *pch_it;
+      }
+    }
+
+    std::map<std::string, uint32_t> named_channels;
+    uint32_t* row = &channels[uint64_t(sid) * num_nodes];
+    const nlohmann::json& routes = sw->at("routes");
+    for (auto it = routes.begin(); it != routes.end(); ++it){
+      NodeId dst = top->nodeNameToId(it.key());
+      if (it.value().is_number()){
+        //this is a single port
+        row[dst] = add_channel(std::vector<int32_t>(1, int(it.value())));
+      } else {
+        std::string pch_name = it.value();
+        auto iter = named_channels.find(pch_name);
+        if (iter == named_channels.end()){
+          std::vector<int32_t> chan_ports;
+          for (auto p : port_channels.at(pch_name).at("ports")){
+            chan_ports.push_back(int(p));
+          }
+          if (chan_ports.empty()){
+            spkt_abort_printf("routing table: port channel %s on switch %s has no ports",
+                              pch_name.c_str(), sw.key().c_str());
+          }
+          iter = named_channels.emplace(pch_name, add_channel(chan_ports)).first;
+        }
+        row[dst] = iter->second;
+      }
+    }
+  }
+
+  for (SwitchId sid=0; sid < num_switches; ++sid){
+    const uint32_t* row = &channels[uint64_t(sid) * num_nodes];
+    for (NodeId dst=0; dst < num_nodes; ++dst){
+      if (row[dst] == no_channel){
+        spkt_abort_printf("No port specified on switch %d to destination %d", sid, dst);
+      }
+    }
+  }
+
+  Header hdr;
+  ::memcpy(hdr.magic, routing_table_magic, sizeof(hdr.magic));
+  hdr.version = version;
+  hdr.num_switches = num_switches;
+  hdr.num_nodes = num_nodes;
+  hdr.num_channels = port_offsets.size() - 1;
+  hdr.num_ports = ports.size();
+
+  size_t channel_bytes = channels.size() * sizeof(uint32_t);
+  size_t offset_bytes = port_offsets.size() * sizeof(uint32_t);
+  size_t port_bytes = ports.size() * sizeof(int32_t);
+  image.resize(sizeof(Header) + channel_bytes + offset_bytes + port_bytes);
+  char* ptr = image.data();
+  ::memcpy(ptr, &hdr, sizeof(Header));
+  ptr += sizeof(Header);
+  ::memcpy(ptr, channels.data(), channel_bytes);
+  ptr += channel_bytes;
+  ::memcpy(ptr, port_offsets.data(), offset_bytes);
+  ptr += offset_bytes;
+  ::memcpy(ptr, ports.data(), port_bytes);
+}
+
+void
+RoutingTable::compile(const std::string& json_fname, Topology* top,
+                      const std::string& out_fname)
+{
+  std::vector<char> image;
+  buildImage(json_fname, top, image);
+  std::ofstream out(out_fname, std::ios::binary);
+  if (out.fail()){
+    spkt_abort_printf("routing table: failed to open %s for writing", out_fname.c_str());
+  }
+  out.write(image.data(), image.size());
+  if (out.fail()){
+    spkt_abort_printf("routing table: failed writing %s", out_fname.c_str());
+  }
+}
+
+}
+}
@@ -0,0 +1,160 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+
+#ifndef sstmac_hardware_router_routing_table_h
+#define sstmac_hardware_router_routing_table_h
+
+#include <sstmac/common/node_address.h>
+#include <sstmac/hardware/topology/topology_fwd.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sstmac {
+namespace hw {
+
+/**
+ * @brief The RoutingTable class holds the routes for every switch in one
+ *  compact read-only image, shared by all switches and threads that name the
+ *  same file. Each table file is read only once per process.
+ *
+ *  The input is either a JSON routing dump or a compiled table written by
+ *  RoutingTable::compile (and the sstmac_compile_routes tool), told apart by
+ *  the magic bytes at the start of the file. A compiled table is mapped
+ *  straight into memory. The binary layout is
+ *
+ *    Header
+ *    uint32_t channels[num_switches][num_nodes]   channel id per destination
+ *    uint32_t port_offsets[num_channels + 1]      CSR row pointers
+ *    int32_t  ports[num_ports]                    ports of each channel
+ *
+ *  A single port is stored as a channel of length one, and identical
+ *  channels are stored only once.
+ */
+class RoutingTable
+{
+ public:
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t num_switches;
+    uint32_t num_nodes;
+    uint32_t num_channels;
+    uint64_t num_ports;
+  };
+
+  static constexpr uint32_t version = 1;
+
+  /**
+   * @brief get
+   * @param fname A JSON or compiled routing table
+   * @param top
+   * @return The shared table for the file, loading it on first use
+   */
+  static const RoutingTable* get(const std::string& fname, Topology* top);
+
+  /**
+   * @brief compile Convert a JSON routing dump into the binary layout
+   * @param json_fname
+   * @param top The topology used to resolve switch and node names
+   * @param out_fname
+   */
+  static void compile(const std::string& json_fname, Topology* top,
+                      const std::string& out_fname);
+
+  static void deleteStatics();
+
+  ~RoutingTable();
+
+  /**
+   * @brief ports
+   * @param sid
+   * @param dst
+   * @param num_ports [out] The number of ports in the channel
+   * @return The ports that can be used to reach dst from switch sid
+   */
+  const int32_t* ports(SwitchId sid, NodeId dst, int& num_ports) const {
+    uint32_t ch = channels_[uint64_t(sid) * num_nodes_ + dst];
+    num_ports = port_offsets_[ch+1] - port_offsets_[ch];
+    return ports_ + port_offsets_[ch];
+  }
+
+  /**
+   * @brief hasChannels
+   * @param sid
+   * @return Whether any destination is reached from switch sid
+   *         through more than one port
+   */
+  bool hasChannels(SwitchId sid) const;
+
+  uint32_t numNodes() const {
+    return num_nodes_;
+  }
+
+ private:
+  RoutingTable(const std::string& fname, Topology* top);
+
+  static void buildImage(const std::string& json_fname, Topology* top,
+                         std::vector<char>& image);
+
+  void setImage(const char* image, size_t size, const std::string& fname,
+                Topology* top);
+
+  std::vector<char> owned_;
+  void* mapped_;
+  size_t mapped_size_;
+
+  uint32_t num_switches_;
+  uint32_t num_nodes_;
+  const uint32_t* channels_;
+  const uint32_t* port_offsets_;
+  const int32_t* ports_;
+};
+
+}
+}
+
+#endif
@@ -43,49 +43,18 @@ Questions? Contact sst-macro-help@sandia.gov
 */
 
 #include <sstmac/hardware/router/router.h>
+#include <sstmac/hardware/router/routing_table.h>
 #include <sstmac/hardware/switch/network_switch.h>
 #include <sstmac/hardware/topology/topology.h>
 #include <sprockit/util.h>
 #include <sprockit/sim_parameters.h>
 #include <sprockit/keyword_registration.h>
-#include <sstmac/hardware/topology/file.h>
-#include <sstmac/libraries/nlohmann/json.hpp>
-#include <sstream>
-#include <fstream>
 
 
 namespace sstmac {
 namespace hw {
 
 class TableRouter : public Router {
- private:
-  struct Port {
-    Port(const nlohmann::json& pch) :
-      rotater(0)
-    {
-      for (auto p : pch.at("ports")){
-        ports.push_back(p);
-      }
-    }
-
-    Port(int port) :
-      ports(1, port),
-      rotater(0)
-    {
-    }
-
-    Port() : rotater(0), ports(0) {}
-
-    int nextPort(){
-      int ret = ports[rotater];
-      rotater = (rotater + 1) % ports.size();
-      return ret;
-    }
-
-    std::vector<int> ports;
-    int rotater;
-  };
-
  public:
   SST_ELI_REGISTER_DERIVED(
     Router,
@@ -96,47 +65,14 @@ class TableRouter : public Router {
     "router implementing table-based routing")
 
   TableRouter(SST::Params& params, Topology* top, NetworkSwitch* sw) :
-    Router(params, top, sw),
-    table_(top->numNodes())
+    Router(params, top, sw)
   {
+    //every switch shares one table, parsed or mapped once per file
     std::string fname = params.find<std::string>("filename");
-    std::ifstream in(fname);
-    nlohmann::json jsn;
-    in >> jsn;
-    FileTopology* file_topo = dynamic_cast<FileTopology*>(top);
-
-    std::string myName = top->switchIdToName(my_addr_);
-    nlohmann::json routes =
-        jsn.at("switches").at(myName).at("routes");
-    nlohmann::json port_channels;
-    if (file_topo){
-      nlohmann::json switch_ports = file_topo->getSwitchJson(myName);
-      auto pch_it = switch_ports.find("port_channels");
-      if (pch_it != switch_ports.end()){
-        port_channels = *pch_it;
-      }
-    }
-
-    for (auto it = routes.begin(); it != routes.end(); ++it){
-      NodeId dest_nid = top->nodeNameToId(it.key());
-      if (it.value().is_number()){
-        //this is a single port
-        table_[dest_nid] = Port(int(it.value()));
-      } else {
-        std::string pch_name = it.value();
-        table_[dest_nid] = Port(port_channels.at(pch_name));
-      }
-    }
-
-
-    int size = table_.size();
-    for (int i=0; i < size; ++i){
-      if (table_[i].ports.size() == 0){
-        spkt_abort_printf("No port specified on switch %d to destination %d",
-                          my_addr_, i);
-      }
+    table_ = RoutingTable::get(fname, top);
+    if (table_->hasChannels(my_addr_)){
+      rotaters_.resize(table_->numNodes(), 0);
     }
-
   }
 
   int numVC() const override {
@@ -148,7 +84,15 @@ class TableRouter : public Router {
   }
 
   void route(Packet *pkt) override {
-    int port = table_[pkt->toaddr()].nextPort();
+    int num_ports;
+    const int32_t* ports = table_->ports(my_addr_, pkt->toaddr(), num_ports);
+    int port = ports[0];
+    if (num_ports > 1){
+      //round-robin over the port channel
+      auto& rotater = rotaters_[pkt->toaddr()];
+      port = ports[rotater];
+      rotater = (rotater + 1) % num_ports;
+    }
     pkt->setEdgeOutport(port);
     //for now only valid on topologies with minimal/no vcs
     pkt->setDeadlockVC(0);
@@ -156,7 +100,9 @@ class TableRouter : public Router {
   }
 
  private:
-  std::vector<Port> table_;
+  const RoutingTable* table_;
+  /** Next port in the channel for each destination, only if there are channels */
+  std::vector<uint16_t> rotaters_;
 };
 
 }
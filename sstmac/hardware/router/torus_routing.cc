@@ -78,6 +78,8 @@ class TorusMinimalRouter : public Router {
   {
     torus_ = safe_cast(Torus, top);
     inj_port_offset_ = 2*torus_->ndimensions();
+    //every minimal hop is a single port
+    next_hops_.init(torus_->numSwitches(), 1, next_hop_budget_);
   }
 
   std::string toString() const override {
@@ -88,39 +90,43 @@ class TorusMinimalRouter : public Router {
     return 2;
   }
 
-  void upPath(int dim, int srcX, int dstX, header* hdr) const
+  /**
+   * How a hop updates the dateline state, which only depends on
+   * the source and destination switch
+   */
+  enum vc_rule {
+    next_dim = 0,
+    cross_timeline = 1,
+    keep_vc = 2
+  };
+
+  int upPath(int dim, int srcX, int dstX) const
   {
     auto& dimensions_ = torus_->dimensions();
     if ((srcX + 1) % dimensions_[dim] == dstX){
       //move onto next dimension
-      hdr->deadlock_vc = 0;
-      hdr->crossed_timeline = 0;
+      return next_dim;
     } else if (srcX == (dimensions_[dim]-1)){
-      hdr->crossed_timeline = 1;
-      hdr->deadlock_vc = 1;
+      return cross_timeline;
     } else {
-      hdr->deadlock_vc = hdr->crossed_timeline ? 1 : 0;
+      return keep_vc;
     }
-    hdr->edge_port = torus_->convertToPort(dim, Torus::pos);
   }
 
-  void downPath(int dim, int src, int dst, header* hdr) const
+  int downPath(int dim, int src, int dst) const
   {
     auto& dimensions_ = torus_->dimensions();
     if (src == ((dst + 1) % dimensions_[dim])){
       //move onto next dimension
-      hdr->deadlock_vc = 0;
-      hdr->crossed_timeline = 0;
+      return next_dim;
     } else if (src == 0){
-      hdr->crossed_timeline = 1;
-      hdr->deadlock_vc = 1;
+      return cross_timeline;
     } else {
-      hdr->deadlock_vc = hdr->crossed_timeline ? 1 : 0;
+      return keep_vc;
     }
-    hdr->edge_port = torus_->convertToPort(dim, Torus::neg);
   }
 
-  void minimalRoute(SwitchId dst, header* hdr){
+  void minimalHop(SwitchId dst, int& port, int& rule) const {
     SwitchId src = my_addr_;
     auto& dimensions_ = torus_->dimensions();
     int div = 1;
@@ -130,22 +136,54 @@ class TorusMinimalRouter : public Router {
       int dstX = (dst / div) % dimensions_[i];
       if (srcX != dstX){
         if (torus_->shortestPathPositive(i, srcX, dstX)){
+          port = torus_->convertToPort(i, Torus::pos);
+          rule = upPath(i, srcX, dstX);
           top_debug("torus routing up on dim %d for switch %d to %d on port %d",
-                    i, src, dst, int(hdr->edge_port));
-          upPath(i, srcX, dstX, hdr);
-          return;
+                    i, src, dst, port);
         } else {
+          port = torus_->convertToPort(i, Torus::neg);
+          rule = downPath(i, srcX, dstX);
           top_debug("torus routing down on dim %d for switch %d to %d on port %d",
-                    i, src, dst, int(hdr->edge_port));
-          downPath(i, srcX, dstX, hdr);
-          return;
+                    i, src, dst, port);
         }
+        return;
       }
       div *= dimensions_[i];
     }
     sprockit::abort("torus: failed to route correctly on torus");
   }
 
+  void minimalRoute(SwitchId dst, header* hdr){
+    int port, rule;
+    if (next_hops_.active()){
+      auto hop = next_hops_.row(dst);
+      if (hop.empty()){
+        minimalHop(dst, port, rule);
+        hop.addPort(port);
+        hop.setTag(rule);
+      }
+      port = hop.port(0);
+      rule = hop.tag();
+    } else {
+      minimalHop(dst, port, rule);
+    }
+
+    switch (rule){
+      case next_dim:
+        hdr->deadlock_vc = 0;
+        hdr->crossed_timeline = 0;
+        break;
+      case cross_timeline:
+        hdr->crossed_timeline = 1;
+        hdr->deadlock_vc = 1;
+        break;
+      default:
+        hdr->deadlock_vc = hdr->crossed_timeline ? 1 : 0;
+        break;
+    }
+    hdr->edge_port = port;
+  }
+
   void route(Packet* pkt) override {
     auto* hdr = pkt->rtrHeader<header>();
     SwitchId ej_addr = pkt->toaddr() / torus_->concentration();
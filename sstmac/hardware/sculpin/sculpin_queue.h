@@ -0,0 +1,140 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+
+#ifndef sculpin_queue_h
+#define sculpin_queue_h
+
+#include <sstmac/hardware/sculpin/sculpin.h>
+#include <vector>
+
+namespace sstmac {
+namespace hw {
+
+/**
+ * @brief A 4-ary min-heap of packets waiting on a sculpin port.
+ *  Packets pop in (priority, arrival, seqnum) order, with zero the highest
+ *  priority. The sort key is copied next to the packet pointer so that sifting
+ *  never dereferences a packet, and the storage is reused once a port has seen
+ *  its deepest queue, so push and pop do not allocate in steady state.
+ */
+class SculpinPortQueue
+{
+ public:
+  bool empty() const {
+    return heap_.empty();
+  }
+
+  int size() const {
+    return heap_.size();
+  }
+
+  SculpinPacket* top() const {
+    return heap_.front().pkt;
+  }
+
+  void push(SculpinPacket* pkt){
+    Entry e;
+    e.priority = pkt->priority();
+    e.seqnum = pkt->seqnum();
+    e.arrival = pkt->arrival();
+    e.pkt = pkt;
+    size_t idx = heap_.size();
+    heap_.push_back(e);
+    while (idx > 0){
+      size_t parent = (idx - 1) / arity;
+      if (!before(e, heap_[parent])) break;
+      heap_[idx] = heap_[parent];
+      idx = parent;
+    }
+    heap_[idx] = e;
+  }
+
+  SculpinPacket* pop(){
+    SculpinPacket* ret = heap_.front().pkt;
+    Entry last = heap_.back();
+    heap_.pop_back();
+    size_t n = heap_.size();
+    if (n == 0) return ret;
+
+    size_t idx = 0;
+    while (true){
+      size_t first = idx * arity + 1;
+      if (first >= n) break;
+      size_t end = first + arity < n ? first + arity : n;
+      size_t best = first;
+      for (size_t c = first + 1; c < end; ++c){
+        if (before(heap_[c], heap_[best])) best = c;
+      }
+      if (!before(heap_[best], last)) break;
+      heap_[idx] = heap_[best];
+      idx = best;
+    }
+    heap_[idx] = last;
+    return ret;
+  }
+
+ private:
+  static constexpr size_t arity = 4;
+
+  struct Entry {
+    int priority;
+    uint32_t seqnum;
+    Timestamp arrival;
+    SculpinPacket* pkt;
+  };
+
+  static bool before(const Entry& l, const Entry& r){
+    if (l.priority != r.priority) return l.priority < r.priority;
+    if (l.arrival != r.arrival) return l.arrival < r.arrival;
+    return l.seqnum < r.seqnum;
+  }
+
+  std::vector<Entry> heap_;
+};
+
+}
+}
+
+#endif // sculpin_queue_h
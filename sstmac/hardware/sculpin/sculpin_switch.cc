@@ -235,9 +235,7 @@ SculpinSwitch::pullNext(int portnum)
                       int(addr()), p.id);
   }
   pkt_debug("pulling pending packet from port %d with %d queued", portnum, p.priority_queue.size());
-  auto iter = p.priority_queue.begin();
-  SculpinPacket* pkt = *iter;
-  p.priority_queue.erase(iter);
+  SculpinPacket* pkt = p.priority_queue.pop();
   send(p, pkt, now());
 }
 
@@ -265,7 +263,7 @@ SculpinSwitch::tryToSendPacket(SculpinPacket* pkt)
       pkt_debug("new packet has to schedule pull from port %d at t=%8.4e", p.id, p.next_free.sec());
     }
     pkt_debug("new packet has to wait on queue on port %d with %d queued", p.id, p.priority_queue.size());
-    p.priority_queue.insert(pkt);
+    p.priority_queue.push(pkt);
   } else if (p.priority_queue.empty()){
     //nothing there - go ahead and send
     send(p, pkt, now_);
@@ -273,7 +271,7 @@ SculpinSwitch::tryToSendPacket(SculpinPacket* pkt)
     //race condition - there is something in the queue
     //I must hop in the queue as well
     pkt_debug("new packet has to wait on queue on port %d with %d queued", p.id, p.priority_queue.size());
-    p.priority_queue.insert(pkt);
+    p.priority_queue.push(pkt);
   }
 }
 
@@ -47,6 +47,7 @@ Questions? Contact sst-macro-help@sandia.gov
 
 #include <sstmac/hardware/switch/network_switch.h>
 #include <sstmac/hardware/sculpin/sculpin.h>
+#include <sstmac/hardware/sculpin/sculpin_queue.h>
 #include <sstmac/common/sstmac_config.h>
 #include <sstmac/common/stats/stat_collector.h>
 #if SSTMAC_VTK_ENABLED
@@ -108,28 +109,13 @@ class SculpinSwitch :
   std::string toString() const override;
 
  private:
-  struct priority_compare {
-    bool operator()(SculpinPacket* l, SculpinPacket* r) const {
-      if (l->priority() == r->priority()){
-        if (l->arrival() == r->arrival()){
-          return l->seqnum() < r->seqnum();
-        } else {
-          return l->arrival() < r->arrival();
-        }
-      } else {
-        //zero is highest priority
-        return l->priority() < r->priority();
-      }
-    }
-  };
-
   struct Port {
     int id;
     int dst_port;
     Timestamp next_free;
     TimeDelta byte_delay;
     uint32_t seqnum;
-    std::set<SculpinPacket*, priority_compare> priority_queue;
+    SculpinPortQueue priority_queue;
     EventLink::ptr link;
     Port() : link(nullptr){}
   };
@@ -109,6 +109,68 @@ SnapprCredit::serialize_order(serializer &ser)
   ser & num_bytes_;
   ser & vl_;
 }
+#if !SSTMAC_INTEGRATED_SST_CORE
+static IpcWire::Registration snappr_packet_wire(IpcWire::SnapprPacket, &SnapprPacket::unpackWire);
+static IpcWire::Registration snappr_credit_wire(IpcWire::SnapprCredit, &SnapprCredit::unpackWire);
+
+size_t
+SnapprPacket::ipcWireSize() const
+{
+  return sizeof(WireFormat) + payloadWireSize();
+}
+
+void
+SnapprPacket::packWire(char* buf) const
+{
+  WireFormat* wire = reinterpret_cast<WireFormat*>(buf);
+  packWireFields(wire->packet, buf + sizeof(WireFormat), payloadWireSize());
+  wire->arrival = arrival_;
+  wire->time_to_send = time_to_send_;
+  wire->congestion_delay = congestion_delay_;
+  wire->offset = offset_;
+  wire->seqnum = seqnum_;
+  wire->priority = priority_;
+  wire->inport = inport_;
+  wire->vl = vl_;
+  wire->input_vl = input_vl_;
+  wire->deadlocked = deadlocked_;
+}
+
+Event*
+SnapprPacket::unpackWire(const char* buf)
+{
+  const WireFormat* wire = reinterpret_cast<const WireFormat*>(buf);
+  SnapprPacket* pkt = new SnapprPacket;
+  pkt->unpackWireFields(wire->packet, buf + sizeof(WireFormat));
+  pkt->arrival_ = wire->arrival;
+  pkt->time_to_send_ = wire->time_to_send;
+  pkt->congestion_delay_ = wire->congestion_delay;
+  pkt->offset_ = wire->offset;
+  pkt->seqnum_ = wire->seqnum;
+  pkt->priority_ = wire->priority;
+  pkt->inport_ = wire->inport;
+  pkt->vl_ = wire->vl;
+  pkt->input_vl_ = wire->input_vl;
+  pkt->deadlocked_ = wire->deadlocked;
+  return pkt;
+}
+
+void
+SnapprCredit::packWire(char* buf) const
+{
+  WireFormat* wire = reinterpret_cast<WireFormat*>(buf);
+  wire->num_bytes = num_bytes_;
+  wire->vl = vl_;
+  wire->port = port_;
+}
+
+Event*
+SnapprCredit::unpackWire(const char* buf)
+{
+  const WireFormat* wire = reinterpret_cast<const WireFormat*>(buf);
+  return new SnapprCredit(wire->num_bytes, wire->vl, wire->port);
+}
+#endif
 
 }
 }
@@ -47,6 +47,7 @@ Questions? Contact sst-macro-help@sandia.gov
 
 #include <sstmac/hardware/common/packet.h>
 #include <sstmac/hardware/common/flow.h>
+#include <sstmac/common/ipc_event.h>
 #include <sprockit/thread_safe_new.h>
 #include <sprockit/factory.h>
 #include <sprockit/debug.h>
@@ -172,7 +173,35 @@ class SnapprPacket :
 
   void serialize_order(serializer& ser) override;
 
+#if !SSTMAC_INTEGRATED_SST_CORE
+  uint32_t ipcWireType() const override {
+    return IpcWire::SnapprPacket;
+  }
+
+  size_t ipcWireSize() const override;
+
+  void packWire(char* buf) const override;
+
+  static Event* unpackWire(const char* buf);
+#endif
+
  private:
+#if !SSTMAC_INTEGRATED_SST_CORE
+  struct WireFormat {
+    Packet::WireFields packet;
+    Timestamp arrival;
+    TimeDelta time_to_send;
+    TimeDelta congestion_delay;
+    uint64_t offset;
+    uint32_t seqnum;
+    int32_t priority;
+    int32_t inport;
+    int32_t vl;
+    int32_t input_vl;
+    int32_t deadlocked;
+  };
+#endif
+
   uint32_t seqnum_;
 
   Timestamp arrival_;
@@ -232,7 +261,29 @@ class SnapprCredit :
 
   void serialize_order(serializer& ser) override;
 
+#if !SSTMAC_INTEGRATED_SST_CORE
+  uint32_t ipcWireType() const override {
+    return IpcWire::SnapprCredit;
+  }
+
+  size_t ipcWireSize() const override {
+    return sizeof(WireFormat);
+  }
+
+  void packWire(char* buf) const override;
+
+  static Event* unpackWire(const char* buf);
+#endif
+
  private:
+#if !SSTMAC_INTEGRATED_SST_CORE
+  struct WireFormat {
+    uint32_t num_bytes;
+    int32_t vl;
+    int32_t port;
+  };
+#endif
+
   uint32_t num_bytes_;
   int vl_;
   int port_;
@@ -0,0 +1,175 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+
+#ifndef snappr_arbitration_h
+#define snappr_arbitration_h
+
+#include <cstdint>
+#include <vector>
+
+namespace sstmac {
+namespace hw {
+
+/**
+ * @brief A FIFO ring buffer that grows by doubling.
+ *  Push and pop never allocate in steady state, unlike std::queue
+ *  which allocates and frees deque blocks as packets flow through.
+ */
+template <class T>
+class RingBuffer {
+ public:
+  RingBuffer() : head_(0), size_(0) {}
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  int size() const {
+    return size_;
+  }
+
+  T& front() {
+    return slots_[head_];
+  }
+
+  const T& front() const {
+    return slots_[head_];
+  }
+
+  void push(const T& t){
+    if (size_ == slots_.size()){
+      grow();
+    }
+    slots_[(head_ + size_) & (slots_.size() - 1)] = t;
+    ++size_;
+  }
+
+  void pop(){
+    head_ = (head_ + 1) & (slots_.size() - 1);
+    --size_;
+  }
+
+ private:
+  void grow(){
+    std::vector<T> bigger(slots_.empty() ? 8 : 2*slots_.size());
+    for (int i=0; i < size_; ++i){
+      bigger[i] = slots_[(head_ + i) & (slots_.size() - 1)];
+    }
+    slots_.swap(bigger);
+    head_ = 0;
+  }
+
+  std::vector<T> slots_;
+  int head_;
+  int size_;
+};
+
+/**
+ * @brief A set of small integers (virtual lanes, QoS levels, priority levels)
+ *  stored as a bitmap, with find-first-set/find-last-set selection.
+ */
+class LaneMask {
+ public:
+  LaneMask(int n = 64) : words_((n + 63) / 64, 0) {}
+
+  void resize(int n){
+    words_.assign((n + 63) / 64, 0);
+  }
+
+  void set(int i){
+    words_[i/64] |= uint64_t(1) << (i%64);
+  }
+
+  void clear(int i){
+    words_[i/64] &= ~(uint64_t(1) << (i%64));
+  }
+
+  bool test(int i) const {
+    return words_[i/64] & (uint64_t(1) << (i%64));
+  }
+
+  bool any() const {
+    for (uint64_t w : words_){
+      if (w) return true;
+    }
+    return false;
+  }
+
+  /** @return The lowest set index, -1 if empty */
+  int first() const {
+    for (int w=0; w < words_.size(); ++w){
+      if (words_[w]) return w*64 + __builtin_ctzll(words_[w]);
+    }
+    return -1;
+  }
+
+  /** @return The highest set index, -1 if empty */
+  int last() const {
+    for (int w=int(words_.size()) - 1; w >= 0; --w){
+      if (words_[w]) return w*64 + 63 - __builtin_clzll(words_[w]);
+    }
+    return -1;
+  }
+
+  /** @brief Call fxn(i) for each set index in increasing order */
+  template <class Fxn>
+  void forEach(Fxn&& fxn) const {
+    for (int w=0; w < words_.size(); ++w){
+      uint64_t bits = words_[w];
+      while (bits){
+        fxn(w*64 + __builtin_ctzll(bits));
+        bits &= bits - 1;
+      }
+    }
+  }
+
+ private:
+  std::vector<uint64_t> words_;
+};
+
+}
+}
+
+#endif
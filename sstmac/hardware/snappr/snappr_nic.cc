@@ -47,6 +47,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/hardware/network/network_message.h>
 #include <sstmac/hardware/memory/memory_model.h>
 #include <sstmac/hardware/snappr/snappr_nic.h>
+#include <sstmac/hardware/snappr/snappr_arbitration.h>
 #include <sstmac/hardware/node/node.h>
 #include <sstmac/software/process/operating_system.h>
 #include <sstmac/common/event_manager.h>
@@ -445,44 +446,47 @@ struct PriorityFIFOQueue : public SnapprNIC::InjectionQueue {
  public:
   SPKT_REGISTER_DERIVED(
     SnapprNIC::InjectionQueue,
-    FIFOQueue,
+    PriorityFIFOQueue,
     "macro",
     "priority_fifo",
-    "implements a FIFO strategy for injecting packets")
+    "implements a FIFO strategy per QoS level, injecting the highest QoS first")
 
   PriorityFIFOQueue(SST::Params& p){
     queues_.resize(p.find<int>("qos_levels", 1));
+    ready_queues_.resize(queues_.size());
   }
 
   std::pair<uint64_t, NetworkMessage*> top() override {
-    int qos = ready_queues_.top();
+    int qos = ready_queues_.last();
     return queues_[qos].front();
   }
 
   void pop() override {
-    int qos = ready_queues_.top();
+    int qos = ready_queues_.last();
     queues_[qos].pop();
     if (queues_[qos].empty()){
-      ready_queues_.pop();
+      ready_queues_.clear(qos);
     }
   }
 
   void adjustTop(uint64_t offset) override {
-    int qos = ready_queues_.top();
+    int qos = ready_queues_.last();
     queues_[qos].front().first = offset;
   }
 
   bool empty() const override {
-    return ready_queues_.empty();
+    return !ready_queues_.any();
   }
 
   void insert(uint64_t byte_offset, NetworkMessage *msg) override {
-    queues_[msg->qos()].emplace(byte_offset, msg);
+    queues_[msg->qos()].push(std::make_pair(byte_offset, msg));
+    ready_queues_.set(msg->qos());
   }
 
  private:
-  std::vector<std::queue<std::pair<uint64_t,NetworkMessage*>>> queues_;
-  std::priority_queue<int, std::vector<int>> ready_queues_;
+  std::vector<RingBuffer<std::pair<uint64_t,NetworkMessage*>>> queues_;
+  /** QoS levels with queued messages, the highest level injects first */
+  LaneMask ready_queues_;
 
 };
 
@@ -497,42 +501,32 @@ struct RoundRobinQueue : public SnapprNIC::InjectionQueue {
     "round_robin",
     "implements a round-robin strategy for injecting packets")
 
-  RoundRobinQueue(SST::Params&  /*p*/) :
-    begin_(0), end_(0), queue_(1024){}
+  RoundRobinQueue(SST::Params&  /*p*/){}
 
   std::pair<uint64_t, NetworkMessage*> top() override {
-    return queue_[begin_];
+    return queue_.front();
   }
 
   void pop() override {
-    begin_++;
-    if (begin_ == queue_.size()){
-      begin_ = 0;
-    }
+    queue_.pop();
   }
 
   bool empty() const override {
-    return begin_ == end_;
+    return queue_.empty();
   }
 
   void adjustTop(uint64_t offset) override {
-    auto& e = queue_[begin_];
-    insert(offset, e.second);
+    NetworkMessage* msg = queue_.front().second;
     pop();
+    insert(offset, msg);
   }
 
   void insert(uint64_t bytes, NetworkMessage* msg) override {
-    queue_[end_] = {bytes,msg};
-    end_++;
-    if (end_ == queue_.size()){
-      end_ = 0;
-    }
+    queue_.push(std::make_pair(bytes, msg));
   }
 
  private:
-  int begin_;
-  int end_;
-  std::vector<std::pair<uint64_t,NetworkMessage*>> queue_;
+  RingBuffer<std::pair<uint64_t,NetworkMessage*>> queue_;
 
 };
 
@@ -52,7 +52,8 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/common/event_callback.h>
 #include <sstmac/common/stats/ftq.h>
 #include <sstmac/common/stats/ftq_tag.h>
-#include <queue>
+#include <sstmac/hardware/snappr/snappr_arbitration.h>
+#include <algorithm>
 
 #include <unusedvariablemacro.h>
 
@@ -83,7 +84,8 @@ SnapprOutPort::SnapprOutPort(uint32_t id, SST::Params& params, const std::string
     congestion_(congestion), 
     portName_(subId), 
     number_(number),
-    notifier_(nullptr)
+    notifier_(nullptr),
+    packet_trains_(false)
 {
   arb_ = sprockit::create<SnapprPortArbitrator>("macro", arb, byte_delay, params, vls_per_qos);
   xmit_active = registerStatistic<uint64_t>(params, "xmit_active", subId);
@@ -105,6 +107,11 @@ SnapprOutPort::SnapprOutPort(uint32_t id, SST::Params& params, const std::string
   flit_overhead = flit_size * byte_delay;
 
   debug_qos_ = params.find<int>("debug_qos", -1);
+
+  //debug QoS requeues its packets and queue depth is sampled per arbitration,
+  //neither of which can be reproduced by a train
+  packet_trains_ = params.find<bool>("packet_trains", true)
+      && debug_qos_ == -1 && !queue_depth_ftq;
 }
 
 void
@@ -133,6 +140,58 @@ SnapprOutPort::handleCredit(SnapprCredit* credit)
 
 void
 SnapprOutPort::send(SnapprPacket* pkt, Timestamp now)
+{
+  transmit(pkt, now);
+  if (packet_trains_){
+    sendTrain(pkt, now);
+  }
+  pkt_debug("packet leaving port=%d vl=%d at t=%8.4e: %s",
+            number_, pkt->virtualLane(), next_free.sec(), pkt->toString().c_str());
+  if (ready()){
+    scheduleArbitration();
+  }
+}
+
+void
+SnapprOutPort::sendTrain(SnapprPacket* engine, Timestamp now)
+{
+  /** Packets of the same flow queued directly behind the one just sent
+   *  would each be popped by their own arbitration at the instant the port
+   *  frees up. The arbitrator order is fixed, so nothing can overtake them:
+   *  hand them all to the link now with their exact start times.
+   *  The train stops at the first packet of another flow or when the
+   *  credit-ready packets run out. */
+  while (ready()){
+    SnapprPacket* next = arb_->peekFixedOrder();
+    if (!next || next->flowId() != engine->flowId()){
+      return;
+    }
+    Timestamp start = next_free;
+    SnapprPacket* car = popReady();
+    train_departures_.push_back(start);
+    pkt_debug("adding packet to train on port=%d vl=%d leaving at t=%8.4e: %s",
+              number_, car->virtualLane(), start.sec(), car->toString().c_str());
+    transmit(car, start);
+  }
+}
+
+int
+SnapprOutPort::trainQueued() const
+{
+  if (train_departures_.empty()){
+    return 0;
+  }
+  /** A train packet counts as queued until the arbitration that would have
+   *  popped it, which runs after any link events at the same time */
+  Timestamp now = parent_->now();
+  while (!train_departures_.empty() && train_departures_.front() < now){
+    train_departures_.pop_front();
+  }
+  return train_departures_.size();
+}
+
+void
+SnapprOutPort::transmit(SnapprPacket* pkt, Timestamp now)
 {
 #if SSTMAC_SANITY_CHECK
   if (next_free > now){
@@ -193,15 +252,16 @@ SnapprOutPort::send(SnapprPacket* pkt, Timestamp now)
     auto* ev = newCallback(this, &SnapprOutPort::handleCredit, credit); //port doesn't matter
     parent_->sendExecutionEvent(next_free, ev);
   } else {
-    //actually send it
-    link->send(flit_overhead, pkt);
+    //actually send it - train packets start after the current time
+    TimeDelta start_delay = now - parent_->now();
+    link->send(start_delay + flit_overhead, pkt);
     if (flow_control_){
       if (inports){
         auto& inport = inports[pkt->inport()];
         auto* credit = new SnapprCredit(pkt->byteLength(), pkt->inputVirtualLane(), inport.src_outport);
         pkt_debug("sending credit to port=%d on vl=%d at t=%8.4e: %s",
                   inport.src_outport, pkt->inputVirtualLane(), next_free.sec(), pkt->toString().c_str());
-        inport.link->send(time_to_send + flit_overhead, credit);
+        inport.link->send(start_delay + time_to_send + flit_overhead, credit);
       }
     } else {
       //immediately add the credits back - we don't worry about credits here
@@ -212,12 +272,6 @@ SnapprOutPort::send(SnapprPacket* pkt, Timestamp now)
   if (notifier_ && pkt->isTail()){
     notifier_->notify(next_free, pkt);
   }
-
-  pkt_debug("packet leaving port=%d vl=%d at t=%8.4e: %s",
-            number_, pkt->virtualLane(), next_free.sec(), pkt->toString().c_str());
-  if (ready()){
-    scheduleArbitration();
-  }
 }
 
 void
@@ -351,7 +405,7 @@ struct FifoPortArbitrator : public SnapprPortArbitrator
   struct VirtualLane {
     uint32_t credits;
     int occupancy;
-    std::queue<SnapprPacket*> pending;
+    RingBuffer<SnapprPacket*> pending;
     VirtualLane() : occupancy(0){}
   };
 
@@ -435,13 +489,17 @@ struct FifoPortArbitrator : public SnapprPortArbitrator
     return pkt;
   }
 
+  SnapprPacket* peekFixedOrder() const override {
+    return port_queue_.empty() ? nullptr : port_queue_.front();
+  }
+
   bool empty() const override {
     return port_queue_.empty();
   }
 
  private:
   std::vector<VirtualLane> vls_;
-  std::queue<SnapprPacket*> port_queue_;
+  RingBuffer<SnapprPacket*> port_queue_;
 };
 
 struct WRR_PortArbitrator : public SnapprPortArbitrator
@@ -462,6 +520,7 @@ struct WRR_PortArbitrator : public SnapprPortArbitrator
      next_free(0),
      credits(0),
      priority(prior),
+     level(0),
      number(num)
    {
    }
@@ -473,7 +532,7 @@ struct WRR_PortArbitrator : public SnapprPortArbitrator
 
    SelectionType sel_type;
 
-   std::queue<SnapprPacket*> pending;
+   RingBuffer<SnapprPacket*> pending;
 
    /** For bandwidth minimum, this is the max amount a byte can be delayed
     *  on a switch and still preserve the minimum.
@@ -502,33 +561,22 @@ struct WRR_PortArbitrator : public SnapprPortArbitrator
 
    int priority;
 
+   /** Rank of the priority among all VLs on the port, 0 is highest */
+   int level;
+
    int number;
  };
 
- struct blockedUntilCompare {
-   bool operator()(const VirtualLane* l,
-                   const VirtualLane* r) const {
-     return l->next_free > r->next_free;
-   }
- };
+ /** VLs with a packet whose bandwidth cap has not expired yet */
+ LaneMask capped_;
 
- std::priority_queue<VirtualLane*, std::vector<VirtualLane*>,
-                     blockedUntilCompare> bw_cap_queue_;
-
- struct priorityDeadlineCompare {
-   bool operator()(const VirtualLane* l,
-                   const VirtualLane* r) const {
-     if (l->priority == r->priority){
-       //those with an earlier next free come later (higher priority)
-       return l->next_free > r->next_free;
-     } else {
-       return l->priority < r->priority;
-     }
-   }
- };
+ /** VLs with a packet ready to arbitrate, one mask per priority level.
+  *  Level 0 is the highest priority. */
+ std::vector<LaneMask> ready_;
+
+ /** Priority levels with at least one ready VL */
+ LaneMask ready_levels_;
 
- std::priority_queue<VirtualLane*, std::vector<VirtualLane*>,
-     priorityDeadlineCompare> port_queue_;
  std::vector<VirtualLane> vls_;
 
  uint64_t link_byte_delay_;
@@ -648,6 +696,16 @@ struct WRR_PortArbitrator : public SnapprPortArbitrator
         spkt_abort_printf("Bad virtual lane type %s given", types[vl].c_str());
       }
     }
+
+    std::vector<int> levels(priorities.begin(), priorities.end());
+    std::sort(levels.begin(), levels.end(), std::greater<int>());
+    levels.erase(std::unique(levels.begin(), levels.end()), levels.end());
+    for (VirtualLane& v : vls_){
+      v.level = std::find(levels.begin(), levels.end(), v.priority) - levels.begin();
+    }
+    ready_.resize(levels.size(), LaneMask(vls_.size()));
+    ready_levels_.resize(levels.size());
+    capped_.resize(vls_.size());
   }
 
   SnapprPacket* popDeadlockCheck(int vl) override {
@@ -699,7 +757,7 @@ struct WRR_PortArbitrator : public SnapprPortArbitrator
     VirtualLane& v = vls_[vl];
     v.next_free = std::numeric_limits<uint64_t>::max();
     //there is no special packet deadline here
-    port_queue_.emplace(&v);
+    makeReady(&v);
     if (v.credits < pkt->numBytes()){
       spkt_abort_printf("WRR %p VL %d no QOS - credits are insufficient",
                         this, pkt->virtualLane());
@@ -717,7 +775,7 @@ struct WRR_PortArbitrator : public SnapprPortArbitrator
       spkt_abort_printf("WRR %p VL %d bandwidth min credits are insufficient",
                         this, pkt->virtualLane());
     }
-    port_queue_.emplace(&v);
+    makeReady(&v);
     v.credits -= pkt->numBytes();
   }
 
@@ -732,12 +790,12 @@ struct WRR_PortArbitrator : public SnapprPortArbitrator
     if (v.next_free > cycle){
       port_debug("WRR %p VL %d is empty and emplacing in cap queue at next_free=%" PRIu64 " on cycle=%" PRIu64 ": %s",
                  this, pkt->virtualLane(), v.next_free, cycle, pkt->toString().c_str());
-      bw_cap_queue_.emplace(&v);
+      capped_.set(v.number);
     } else {
       port_debug("WRR %p VL %d is empty and emplacing in port queue at next_free=%" PRIu64 " on cycle=%" PRIu64 ": %s",
                  this, pkt->virtualLane(), v.next_free, cycle, pkt->toString().c_str());
       v.next_free = cycle;
-      port_queue_.emplace(&v);
+      makeReady(&v);
     }
   }
 
@@ -773,7 +831,7 @@ struct WRR_PortArbitrator : public SnapprPortArbitrator
       //the deadline can be whatever we set
       vl->next_free = cycle;
       vl->credits -= pkt->numBytes();
-      port_queue_.emplace(vl);
+      makeReady(vl);
     } else {
       vl->stalled = true;
     }
@@ -804,7 +862,7 @@ struct WRR_PortArbitrator : public SnapprPortArbitrator
     SnapprPacket* next = vl->pending.front();
     if (vl->credits >= next->numBytes()){
       //and if I have enough credits, put me in for arbitration
-      bw_cap_queue_.emplace(vl);
+      capped_.set(vl->number);
       port_debug("WRR %p VL %d has enough credits=%u to emplace in cap queue at next_free=%" PRIu64
                  " on cycle=%" PRIu64 ": %s",
                  this, vl->number, vl->credits, vl->next_free, cycle, next->toString().c_str());
@@ -827,7 +885,7 @@ struct WRR_PortArbitrator : public SnapprPortArbitrator
                  this, vl->number, vl->credits, deadline, cycle, pkt->toString().c_str());
       vl->next_free = deadline;
       vl->credits -= pkt->numBytes();
-      port_queue_.emplace(vl);
+      makeReady(vl);
     } else {
       port_debug("WRR %p VL %d has insufficient credits=%u for deadline=%" PRIu64
                  " on cycle=%" PRIu64 ": %s",
@@ -837,27 +895,60 @@ struct WRR_PortArbitrator : public SnapprPortArbitrator
     }
   }
 
+  void makeReady(VirtualLane* vl){
+#if SSTMAC_SANITY_CHECK
+    if (ready_[vl->level].test(vl->number)){
+      spkt_abort_printf("WRR %p VL %d is already ready to arbitrate", this, vl->number);
+    }
+#endif
+    ready_[vl->level].set(vl->number);
+    ready_levels_.set(vl->level);
+  }
+
+  /**
+   * @brief Select the VL in the mask with the earliest next_free,
+   *  breaking ties in favor of the lowest VL number
+   */
+  VirtualLane* earliest(const LaneMask& mask){
+    VirtualLane* best = nullptr;
+    mask.forEach([&](int i){
+      VirtualLane* vl = &vls_[i];
+      if (!best || vl->next_free < best->next_free){
+        best = vl;
+      }
+    });
+    return best;
+  }
+
   SnapprPacket* pop(uint64_t cycle) override {
 #if SSTMAC_SANITY_CHECK
-    if (bw_cap_queue_.empty() && port_queue_.empty()){
+    if (empty()){
       spkt_abort_printf("WRR %p pulling snappr packet from empty queue", this);
     }
 #endif
-    while (!bw_cap_queue_.empty() && bw_cap_queue_.top()->next_free <= cycle){
-      VirtualLane* vl = bw_cap_queue_.top();
-      port_queue_.emplace(vl);
-      bw_cap_queue_.pop();
+    if (capped_.any()){
+      capped_.forEach([&](int i){
+        VirtualLane* vl = &vls_[i];
+        if (vl->next_free <= cycle){
+          capped_.clear(i);
+          makeReady(vl);
+        }
+      });
     }
 
     VirtualLane* vl = nullptr;
-    if (port_queue_.empty()){
-      //just take the top packet from the bw_cap_queue
-      vl = bw_cap_queue_.top();
-      //port_queue_.emplace(vl);
-      bw_cap_queue_.pop();
+    int level = ready_levels_.first();
+    if (level < 0){
+      //just take the earliest VL waiting on its bandwidth cap
+      vl = earliest(capped_);
+      capped_.clear(vl->number);
     } else {
-      vl = port_queue_.top();
-      port_queue_.pop();
+      LaneMask& ready = ready_[level];
+      vl = earliest(ready);
+      ready.clear(vl->number);
+      if (!ready.any()){
+        ready_levels_.clear(level);
+      }
     }
 
 #if SSTMAC_SANITY_CHECK
@@ -904,19 +995,19 @@ struct WRR_PortArbitrator : public SnapprPortArbitrator
    * @param vl
    */
   void unstallNoQoS(VirtualLane* vl){
-    port_queue_.emplace(vl);
+    makeReady(vl);
   }
 
   void unstallBandwidthMax(VirtualLane* vl){
     port_debug("WRR %p VL %d now has enough credits for next_free %" PRIu64,
                this, vl->number, vl->next_free);
-    bw_cap_queue_.emplace(vl);
+    capped_.set(vl->number);
   }
 
   void unstallBandwidthMin(VirtualLane* vl){
     port_debug("WRR %p VL %d now has enough credits for deadline %" PRIu64,
                this, vl->number, vl->next_free);
-    port_queue_.emplace(vl);
+    makeReady(vl);
   }
 
   void addCredits(int vl, uint32_t credits) override {
@@ -951,7 +1042,7 @@ struct WRR_PortArbitrator : public SnapprPortArbitrator
   }
 
   bool empty() const override {
-    return port_queue_.empty() && bw_cap_queue_.empty();
+    return !ready_levels_.any() && !capped_.any();
   }
 };
 
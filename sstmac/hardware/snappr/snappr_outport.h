@@ -51,6 +51,8 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/hardware/snappr/snappr.h>
 #include <sstmac/hardware/snappr/snappr_inport.h>
 
+#include <deque>
+
 namespace sstmac {
 namespace hw {
 
@@ -66,6 +68,14 @@ struct SnapprPortArbitrator {
 
   virtual SnapprPacket* pop(uint64_t cycle) = 0;
 
+  /**
+   * @brief Peek at the packet pop() will return next. Only arbitrators whose
+   *  service order is fixed once a packet is ready (no later insert or credit
+   *  can overtake it) implement this. Ports build packet trains only from these.
+   * @return The next packet, or null if empty or the order is not fixed
+   */
+  virtual SnapprPacket* peekFixedOrder() const { return nullptr; }
+
   virtual bool empty() const = 0;
 
   virtual void scale(double factor) = 0;
@@ -160,7 +170,7 @@ struct SnapprOutPort : public SubComponent {
   }
 
   int queueLength() const {
-    return total_packets_;
+    return total_packets_ + trainQueued();
   }
 
   bool ready() const {
@@ -222,6 +232,12 @@ struct SnapprOutPort : public SubComponent {
 
   void send(SnapprPacket* pktr, Timestamp now);
 
+  void transmit(SnapprPacket* pkt, Timestamp start);
+
+  void sendTrain(SnapprPacket* engine, Timestamp now);
+
+  int trainQueued() const;
+
   int debug_qos_;
   SnapprPortArbitrator* arb_;
   Component* parent_;
@@ -232,6 +248,10 @@ struct SnapprOutPort : public SubComponent {
   int number_;
   TailNotifier* notifier_;
   std::set<int> deadlocked_vls_;
+  bool packet_trains_;
+  /** Departure times of train packets already handed to the link,
+   *  which still count as queued until they would have been arbitrated */
+  mutable std::deque<Timestamp> train_departures_;
 
 };
 
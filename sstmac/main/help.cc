@@ -68,6 +68,8 @@ printHelp(int  /*argc*/, char **argv)
             << "\t[(--include|-i)           <value> ]    \n"
             << "\t[(--runnumber|-r)         <value> ]    \n"
             << "\t[(--cpu-affinity|-c)      <value>,<value>,... ]    \n"
+            << "\t[--restart               <checkpoint file> ]    \n"
+            << "\t[--shutdown-checkpoint   <checkpoint file> ]    \n"
             << "\n"
 
             << "Configuration file is not optional. See parameters.ini for \n"
@@ -82,6 +84,9 @@ printHelp(int  /*argc*/, char **argv)
             << "and can turn off printing the simulation at the end with -m notime \n"
             << "\n--cpu-affinity takes a comma separated list of processor affinities\n"
             << "with size equal to the number of PDES tasks per node\n"
+            << "\n--restart resumes a simulation from the checkpoint server started\n"
+            << "by a run with checkpoint_time and checkpoint_file set. Output goes to\n"
+            << "the current directory. --shutdown-checkpoint stops the server.\n"
             << "\n" << "Valid arguments to --debug (-d) are strings of the form \n"
             << "\"<(debug|stats)> (name1) | (name2) | ... \" \n"
             << "\t- examples: \n"
@@ -133,6 +133,8 @@ parseOpts(int argc, char **argv, opts &oo)
     { "graph", required_argument, NULL, 'g' },
     { "xyz", required_argument, NULL, 'x' },
     { "dump-params", required_argument, NULL, 'D'},
+    { "restart", required_argument, NULL, 'R'},
+    { "shutdown-checkpoint", required_argument, NULL, 'S'},
     { NULL, 0, NULL, '\0' }
   };
   int ch;
@@ -176,6 +178,14 @@ parseOpts(int argc, char **argv, opts &oo)
       case 'D':
         oo.params_dump_file = optarg;
         break;
+      case 'R':
+        oo.restart_file = optarg;
+        need_config_file = false;
+        break;
+      case 'S':
+        oo.shutdown_file = optarg;
+        need_config_file = false;
+        break;
       case 'f':
         oo.configfile = optarg;
         oo.got_config_file = true;
@@ -59,6 +59,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/backends/common/parallel_runtime.h>
 #include <sstmac/backends/native/serial_runtime.h>
 #include <sstmac/backends/native/manager.h>
+#include <sstmac/backends/native/checkpoint.h>
 #include <sstmac/software/process/app.h>
 #include <sstmac/software/process/operating_system.h>
 #include <sstmac/software/process/time.h>
@@ -303,6 +304,20 @@ tryMain(sprockit::SimParameters::ptr params,
   SimStats stats;
   sstmac::initOpts(oo, argc, argv);
 
+#if !SSTMAC_INTEGRATED_SST_CORE
+  if (!oo.restart_file.empty() || !oo.shutdown_file.empty()){
+    //the simulation itself resumes inside the checkpoint server
+    int rc = oo.restart_file.empty()
+        ? native::Checkpoint::shutdown(oo.shutdown_file)
+        : native::Checkpoint::restart(oo.restart_file);
+    if (rt){
+      rt->finalize();
+      delete rt;
+    }
+    return rc;
+  }
+#endif
+
   bool parallel = rt && rt->nproc() > 1;
   sstmac::initParams(rt, oo, params, parallel);
 
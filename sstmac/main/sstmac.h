@@ -72,6 +72,8 @@ struct opts {
   std::string outputGraphviz;
   std::string outputXYZ;
   std::string params_dump_file;
+  std::string restart_file;
+  std::string shutdown_file;
 
   opts() :
     help(0),
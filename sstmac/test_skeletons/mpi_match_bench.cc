@@ -0,0 +1,146 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+
+#include <sstmac/util.h>
+#include <sstmac/replacements/mpi.h>
+#include <sstmac/skeleton.h>
+#include <sprockit/keyword_registration.h>
+#include <vector>
+
+RegisterKeywords(
+ { "num_recvs", "the number of receives each rank keeps outstanding" },
+ { "wildcard_stride", "post every Nth receive with MPI_ANY_SOURCE, 0 for none" },
+);
+
+#define sstmac_app_name mpi_match_bench
+
+/**
+ * Stress MPI message matching: every rank keeps num_recvs receives outstanding
+ * from its left neighbor while the neighbor sends in the opposite order, then
+ * repeats with the messages arriving before the receives are posted. Statuses
+ * are checked so the benchmark doubles as a test of matching order.
+ */
+static void
+checkTag(int me, const char* phase, int expected, const MPI_Status& stat)
+{
+  if (stat.MPI_TAG != expected){
+    ::printf("Rank %d: %s receive matched tag %d, expected %d\n",
+             me, phase, stat.MPI_TAG, expected);
+    ::abort();
+  }
+}
+
+int USER_MAIN(int argc, char** argv)
+{
+  MPI_Init(&argc, &argv);
+
+  int me, nproc;
+  MPI_Comm_rank(MPI_COMM_WORLD, &me);
+  MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+  int num_recvs = sstmac::getParam<int>("num_recvs", 1000);
+  int wildcard_stride = sstmac::getParam<int>("wildcard_stride", 0);
+  int send_to = (me + 1) % nproc;
+  int recv_from = (me - 1 + nproc) % nproc;
+
+  std::vector<MPI_Request> recv_reqs(num_recvs);
+  std::vector<MPI_Request> send_reqs(num_recvs);
+  std::vector<MPI_Status> stats(num_recvs);
+
+  auto source = [&](int i){
+    return (wildcard_stride && i % wildcard_stride == 0) ? MPI_ANY_SOURCE : recv_from;
+  };
+
+  double t_start = MPI_Wtime();
+
+  //posted receives: each message has to pass every receive posted before it
+  for (int i=0; i < num_recvs; ++i){
+    MPI_Irecv(NULL, 1, MPI_INT, source(i), i, MPI_COMM_WORLD, &recv_reqs[i]);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+  for (int i=num_recvs-1; i >= 0; --i){
+    MPI_Isend(NULL, 1, MPI_INT, send_to, i, MPI_COMM_WORLD, &send_reqs[i]);
+  }
+  MPI_Waitall(num_recvs, recv_reqs.data(), stats.data());
+  MPI_Waitall(num_recvs, send_reqs.data(), MPI_STATUSES_IGNORE);
+  for (int i=0; i < num_recvs; ++i){
+    checkTag(me, "posted", i, stats[i]);
+  }
+
+  //unexpected messages: each receive has to pass every message that arrived before it
+  for (int i=0; i < num_recvs; ++i){
+    MPI_Isend(NULL, 1, MPI_INT, send_to, i, MPI_COMM_WORLD, &send_reqs[i]);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+  for (int i=num_recvs-1; i >= 0; --i){
+    MPI_Irecv(NULL, 1, MPI_INT, source(i), i, MPI_COMM_WORLD, &recv_reqs[i]);
+  }
+  MPI_Waitall(num_recvs, recv_reqs.data(), stats.data());
+  MPI_Waitall(num_recvs, send_reqs.data(), MPI_STATUSES_IGNORE);
+  for (int i=0; i < num_recvs; ++i){
+    checkTag(me, "unexpected", i, stats[i]);
+  }
+
+  //full wildcards must match in send order
+  for (int i=0; i < num_recvs; ++i){
+    MPI_Irecv(NULL, 1, MPI_INT, MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &recv_reqs[i]);
+  }
+  for (int i=0; i < num_recvs; ++i){
+    MPI_Isend(NULL, 1, MPI_INT, send_to, i, MPI_COMM_WORLD, &send_reqs[i]);
+  }
+  MPI_Waitall(num_recvs, recv_reqs.data(), stats.data());
+  MPI_Waitall(num_recvs, send_reqs.data(), MPI_STATUSES_IGNORE);
+  for (int i=0; i < num_recvs; ++i){
+    checkTag(me, "wildcard", i, stats[i]);
+  }
+
+  double t_total = MPI_Wtime() - t_start;
+  if (me == 0){
+    ::printf("Matched %d receives per rank in %8.4fms\n", 3*num_recvs, t_total*1e3);
+  }
+
+  MPI_Finalize();
+  return 0;
+}
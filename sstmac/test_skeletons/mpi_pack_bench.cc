@@ -0,0 +1,149 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+#include <sstmac/util.h>
+#include <sstmac/replacements/mpi.h>
+#include <sstmac/skeleton.h>
+#include <sprockit/keyword_registration.h>
+#include <vector>
+
+RegisterKeywords(
+ { "block_size", "the edge length in doubles of each rank's cubic block" },
+ { "num_iterations", "the number of halo exchanges to run" },
+);
+
+#define sstmac_app_name mpi_pack_bench
+
+/**
+ * Stress datatype packing: every rank owns an n x n x n block of doubles and
+ * repeatedly exchanges two faces with its ring neighbors through derived
+ * datatypes, with real buffers on both sides. The x face is a strided gather
+ * of single doubles, the y face a strided gather of rows. Received faces are
+ * checked, so the benchmark doubles as a test of pack and unpack.
+ */
+static double
+cellValue(int rank, int iter, int i, int j, int k)
+{
+  return rank*1e6 + iter*1e3 + i + 0.5*j + 0.25*k;
+}
+
+static void
+checkFace(int me, const char* face, double expected, double got)
+{
+  if (expected != got){
+    ::printf("Rank %d: %s face received %f, expected %f\n",
+             me, face, got, expected);
+    ::abort();
+  }
+}
+
+int USER_MAIN(int argc, char** argv)
+{
+  MPI_Init(&argc, &argv);
+
+  int me, nproc;
+  MPI_Comm_rank(MPI_COMM_WORLD, &me);
+  MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+  int n = sstmac::getParam<int>("block_size", 32);
+  int num_iterations = sstmac::getParam<int>("num_iterations", 10);
+  int send_to = (me + 1) % nproc;
+  int recv_from = (me - 1 + nproc) % nproc;
+
+  auto idx = [=](int i, int j, int k){ return (k*n + j)*n + i; };
+  std::vector<double> block(n*n*n);
+
+  //fixed i: one double out of every row
+  MPI_Datatype x_face;
+  MPI_Type_vector(n*n, 1, n, MPI_DOUBLE, &x_face);
+  MPI_Type_commit(&x_face);
+
+  //fixed j: one row out of every plane
+  MPI_Datatype y_face;
+  MPI_Type_vector(n, n, n*n, MPI_DOUBLE, &y_face);
+  MPI_Type_commit(&y_face);
+
+  double t_start = MPI_Wtime();
+
+  for (int iter=0; iter < num_iterations; ++iter){
+    for (int k=0; k < n; ++k){
+      for (int j=0; j < n; ++j){
+        block[idx(n-1,j,k)] = cellValue(me, iter, n-1, j, k);
+      }
+      for (int i=0; i < n; ++i){
+        block[idx(i,n-1,k)] = cellValue(me, iter, i, n-1, k);
+      }
+    }
+
+    //send the high faces, receive into the low faces
+    MPI_Sendrecv(&block[idx(0,n-1,0)], 1, y_face, send_to, 1,
+                 &block[idx(0,0,0)], 1, y_face, recv_from, 1,
+                 MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    for (int k=0; k < n; ++k){
+      for (int i=0; i < n; ++i){
+        checkFace(me, "y", cellValue(recv_from, iter, i, n-1, k), block[idx(i,0,k)]);
+      }
+    }
+
+    //the x faces share the j=0 edge with the y face just received
+    MPI_Sendrecv(&block[idx(n-1,0,0)], 1, x_face, send_to, 0,
+                 &block[idx(0,0,0)], 1, x_face, recv_from, 0,
+                 MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    for (int k=0; k < n; ++k){
+      for (int j=1; j < n; ++j){
+        checkFace(me, "x", cellValue(recv_from, iter, n-1, j, k), block[idx(0,j,k)]);
+      }
+    }
+  }
+
+  double t_total = MPI_Wtime() - t_start;
+  if (me == 0){
+    ::printf("Exchanged %d faces per rank in %8.4fms\n", 2*num_iterations, t_total*1e3);
+  }
+
+  MPI_Type_free(&x_face);
+  MPI_Type_free(&y_face);
+
+  MPI_Finalize();
+  return 0;
+}
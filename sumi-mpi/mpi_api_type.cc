@@ -507,7 +507,7 @@ MpiApi::typeContiguous(int count, MPI_Datatype old_type,
   MPI_Aint byte_stride = count * old_type_obj->extent();
   new_type_obj->init_vector("contiguous-" + old_type_obj->label,
                         old_type_obj,
-                        count, 1, byte_stride);
+                        1, count, byte_stride);
 
   allocateTypeId(new_type_obj);
   *new_type = new_type_obj->id;
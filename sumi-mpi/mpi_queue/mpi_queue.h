@@ -64,6 +64,7 @@ Questions? Contact sst-macro-help@sandia.gov
 
 #include <sumi-mpi/mpi_queue/mpi_queue_recv_request_fwd.h>
 #include <sumi-mpi/mpi_queue/mpi_queue_probe_request_fwd.h>
+#include <sumi-mpi/mpi_queue/mpi_queue_match.h>
 
 #include <sprockit/sim_parameters_fwd.h>
 
@@ -192,8 +193,9 @@ class MpiQueue
   std::unordered_map<TaskId, hold_list_t> held_;
 
   /// Inbound messages waiting for a matching receive request.
-  std::list<MpiMessage*> need_recv_match_;
-  std::list<MpiQueueRecvRequest*> need_send_match_;
+  MpiUnexpectedQueue need_recv_match_;
+  /// Posted receive requests waiting for a matching message.
+  MpiPostedQueue need_send_match_;
 
   std::vector<MpiProtocol*> protocols_;
 
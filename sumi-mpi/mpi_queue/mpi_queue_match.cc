@@ -0,0 +1,156 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+
+#include <sumi-mpi/mpi_queue/mpi_queue_match.h>
+#include <sumi-mpi/mpi_queue/mpi_queue_recv_request.h>
+#include <sprockit/errors.h>
+
+namespace sumi {
+
+void
+MpiUnexpectedQueue::push(MpiMessage* msg)
+{
+  auto it = arrivals_.insert(arrivals_.end(), msg);
+  MpiMatchKey key{msg->comm(), msg->srcRank(), msg->tag()};
+  bins_[key].push_back(it);
+}
+
+MpiUnexpectedQueue::arrival_list::const_iterator
+MpiUnexpectedQueue::findArrival(MPI_Comm comm, int source, int tag) const
+{
+  if (source != MPI_ANY_SOURCE && tag != MPI_ANY_TAG){
+    auto iter = bins_.find(MpiMatchKey{comm, source, tag});
+    if (iter == bins_.end()){
+      return arrivals_.end();
+    }
+    return iter->second.front();
+  }
+
+  for (auto it = arrivals_.begin(); it != arrivals_.end(); ++it){
+    MpiMessage* msg = *it;
+    if (msg->comm() == comm
+        && (source == MPI_ANY_SOURCE || source == msg->srcRank())
+        && (tag == MPI_ANY_TAG || tag == msg->tag())){
+      return it;
+    }
+  }
+  return arrivals_.end();
+}
+
+MpiMessage*
+MpiUnexpectedQueue::find(MPI_Comm comm, int source, int tag) const
+{
+  auto it = findArrival(comm, source, tag);
+  return it == arrivals_.end() ? nullptr : *it;
+}
+
+MpiMessage*
+MpiUnexpectedQueue::pop(MPI_Comm comm, int source, int tag)
+{
+  auto it = findArrival(comm, source, tag);
+  if (it == arrivals_.end()){
+    return nullptr;
+  }
+
+  MpiMessage* msg = *it;
+  //the earliest match is always the oldest message with its own signature
+  auto iter = bins_.find(MpiMatchKey{msg->comm(), msg->srcRank(), msg->tag()});
+  iter->second.pop_front();
+  if (iter->second.empty()){
+    bins_.erase(iter);
+  }
+  arrivals_.erase(it);
+  return msg;
+}
+
+void
+MpiPostedQueue::push(MpiQueueRecvRequest* req)
+{
+  MpiMatchKey key{req->comm_, req->source_, req->tag_};
+  bins_[key].push_back(posted{next_seqnum_++, req});
+  ++size_;
+}
+
+MpiQueueRecvRequest*
+MpiPostedQueue::pop(MpiMessage* msg)
+{
+  MpiMatchKey keys[4] = {
+    {msg->comm(), msg->srcRank(), msg->tag()},
+    {msg->comm(), MPI_ANY_SOURCE, msg->tag()},
+    {msg->comm(), msg->srcRank(), MPI_ANY_TAG},
+    {msg->comm(), MPI_ANY_SOURCE, MPI_ANY_TAG}
+  };
+
+  bin_map::iterator best = bins_.end();
+  for (auto& key : keys){
+    auto iter = bins_.find(key);
+    if (iter == bins_.end()) continue;
+
+    bin& b = iter->second;
+    while (!b.empty() && b.front().req->isCancelled()){
+      b.pop_front();
+      --size_;
+    }
+    if (b.empty()){
+      bins_.erase(iter);
+    } else if (best == bins_.end() || b.front().seqnum < best->second.front().seqnum){
+      best = iter;
+    }
+  }
+
+  if (best == bins_.end()){
+    return nullptr;
+  }
+
+  MpiQueueRecvRequest* req = best->second.front().req;
+  best->second.pop_front();
+  if (best->second.empty()){
+    bins_.erase(best);
+  }
+  --size_;
+  return req;
+}
+
+}
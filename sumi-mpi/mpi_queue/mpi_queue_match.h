@@ -0,0 +1,156 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+
+#ifndef SSTMAC_SOFTWARE_LIBRARIES_MPI_MPI_QUEUE_MPIQUEUE_MATCH_H_INCLUDED
+#define SSTMAC_SOFTWARE_LIBRARIES_MPI_MPI_QUEUE_MPIQUEUE_MATCH_H_INCLUDED
+
+#include <sumi-mpi/mpi_message.h>
+#include <sumi-mpi/mpi_queue/mpi_queue_recv_request_fwd.h>
+
+#include <deque>
+#include <list>
+#include <unordered_map>
+
+namespace sumi {
+
+/**
+ * The (comm, source, tag) signature used to bin messages and receives.
+ * For posted receives the source and tag may be wildcards.
+ */
+struct MpiMatchKey {
+  MPI_Comm comm;
+  int source;
+  int tag;
+
+  bool operator==(const MpiMatchKey& other) const {
+    return comm == other.comm && source == other.source && tag == other.tag;
+  }
+};
+
+struct MpiMatchKeyHash {
+  size_t operator()(const MpiMatchKey& key) const {
+    uint64_t h = uint64_t(key.comm) * 0x9E3779B97F4A7C15ULL;
+    h ^= (uint64_t(uint32_t(key.source)) << 32) | uint32_t(key.tag);
+    h *= 0xC2B2AE3D27D4EB4FULL;
+    return h ^ (h >> 29);
+  }
+};
+
+/**
+ * @brief Inbound messages waiting for a matching receive, in arrival order.
+ * Messages are binned on their exact signature so a fully specified receive
+ * or probe only looks at the front of one bin. Wildcard lookups walk the
+ * arrival list, whose first match is always the front of its own bin.
+ */
+class MpiUnexpectedQueue
+{
+ public:
+  void push(MpiMessage* msg);
+
+  /**
+   * @return The earliest message matching the signature, which may contain
+   *         wildcards, or null if there is none
+   */
+  MpiMessage* find(MPI_Comm comm, int source, int tag) const;
+
+  /**
+   * @brief pop Like find, but removes the message from the queue
+   */
+  MpiMessage* pop(MPI_Comm comm, int source, int tag);
+
+  size_t size() const {
+    return arrivals_.size();
+  }
+
+ private:
+  using arrival_list = std::list<MpiMessage*>;
+
+  arrival_list::const_iterator findArrival(MPI_Comm comm, int source, int tag) const;
+
+  arrival_list arrivals_;
+  std::unordered_map<MpiMatchKey, std::deque<arrival_list::iterator>, MpiMatchKeyHash> bins_;
+};
+
+/**
+ * @brief Posted receives waiting for a matching message.
+ * Receives are binned on their own signature, wildcards included, so an
+ * incoming message only checks the fronts of its exact bin and the three
+ * wildcard bins (any source, any tag, both). A posting sequence number picks
+ * the earliest of those, which preserves MPI's non-overtaking order.
+ */
+class MpiPostedQueue
+{
+ public:
+  MpiPostedQueue() : next_seqnum_(0), size_(0) {}
+
+  void push(MpiQueueRecvRequest* req);
+
+  /**
+   * @return The earliest posted, non-cancelled receive matching msg,
+   *         removed from the queue, or null if there is none
+   */
+  MpiQueueRecvRequest* pop(MpiMessage* msg);
+
+  size_t size() const {
+    return size_;
+  }
+
+ private:
+  struct posted {
+    uint64_t seqnum;
+    MpiQueueRecvRequest* req;
+  };
+
+  using bin = std::deque<posted>;
+  using bin_map = std::unordered_map<MpiMatchKey, bin, MpiMatchKeyHash>;
+
+  bin_map bins_;
+  uint64_t next_seqnum_;
+  size_t size_;
+};
+
+}
+
+#endif
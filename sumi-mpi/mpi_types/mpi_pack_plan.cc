@@ -0,0 +1,189 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+#include <sumi-mpi/mpi_types/mpi_pack_plan.h>
+#include <sumi-mpi/mpi_types/mpi_type.h>
+#include <sprockit/errors.h>
+#include <cstring>
+
+namespace sumi {
+
+/**
+ * Fixed-size kernels let the compiler turn each copy into a few moves
+ * instead of a call into memcpy, which matters for runs of single elements.
+ */
+template <size_t N>
+static void
+gatherFixed(char* packed, const char* unpacked, size_t /*length*/, ptrdiff_t stride, int count)
+{
+  for (int i=0; i < count; ++i, packed += N, unpacked += stride){
+    ::memcpy(packed, unpacked, N);
+  }
+}
+
+template <size_t N>
+static void
+scatterFixed(const char* packed, char* unpacked, size_t /*length*/, ptrdiff_t stride, int count)
+{
+  for (int i=0; i < count; ++i, packed += N, unpacked += stride){
+    ::memcpy(unpacked, packed, N);
+  }
+}
+
+static void
+gatherAny(char* packed, const char* unpacked, size_t length, ptrdiff_t stride, int count)
+{
+  for (int i=0; i < count; ++i, packed += length, unpacked += stride){
+    ::memcpy(packed, unpacked, length);
+  }
+}
+
+static void
+scatterAny(const char* packed, char* unpacked, size_t length, ptrdiff_t stride, int count)
+{
+  for (int i=0; i < count; ++i, packed += length, unpacked += stride){
+    ::memcpy(unpacked, packed, length);
+  }
+}
+
+void
+MpiPackPlan::compile(const MpiType* type)
+{
+  runs_.clear();
+  flatten(type, 0);
+  foldLast();
+
+  for (run& r : runs_){
+    switch (r.length){
+    case 1: r.gather = &gatherFixed<1>; r.scatter = &scatterFixed<1>; break;
+    case 2: r.gather = &gatherFixed<2>; r.scatter = &scatterFixed<2>; break;
+    case 4: r.gather = &gatherFixed<4>; r.scatter = &scatterFixed<4>; break;
+    case 8: r.gather = &gatherFixed<8>; r.scatter = &scatterFixed<8>; break;
+    case 16: r.gather = &gatherFixed<16>; r.scatter = &scatterFixed<16>; break;
+    case 32: r.gather = &gatherFixed<32>; r.scatter = &scatterFixed<32>; break;
+    default: r.gather = &gatherAny; r.scatter = &scatterAny; break;
+    }
+  }
+  compiled_ = true;
+}
+
+void
+MpiPackPlan::flatten(const MpiType* type, ptrdiff_t offset)
+{
+  switch (type->type_){
+  case MpiType::PRIM: {
+    append(offset, type->size_);
+    break;
+  }
+  case MpiType::PAIR: {
+    int first_size = type->pdata_->base1->size_;
+    append(offset, first_size);
+    append(offset + first_size, type->pdata_->base2->size_);
+    break;
+  }
+  case MpiType::VEC: {
+    const vecdata* vdata = type->vdata_;
+    ptrdiff_t base_extent = vdata->base->extent();
+    for (int j=0; j < vdata->count; ++j){
+      ptrdiff_t block_offset = offset + ptrdiff_t(vdata->byte_stride) * j;
+      for (int b=0; b < vdata->blocklen; ++b){
+        flatten(vdata->base, block_offset + base_extent * b);
+      }
+    }
+    break;
+  }
+  case MpiType::IND: {
+    ptrdiff_t block_offset = offset;
+    for (const ind_block& block : type->idata_->blocks){
+      ptrdiff_t base_extent = block.base->extent();
+      for (int k=0; k < block.num; ++k){
+        flatten(block.base, block_offset + base_extent * k);
+      }
+      block_offset += base_extent * block.num;
+    }
+    break;
+  }
+  case MpiType::NONE: {
+    spkt_abort_printf("MpiPackPlan::compile: cannot pack NONE type %s",
+                      type->label.c_str());
+  }
+  }
+}
+
+void
+MpiPackPlan::append(ptrdiff_t offset, size_t length)
+{
+  if (length == 0) return;
+
+  if (!runs_.empty()){
+    run& last = runs_.back();
+    if (last.count == 1 && offset == last.offset + ptrdiff_t(last.length)){
+      last.length += length;
+      return;
+    }
+    //the last run can no longer grow, see if it continues the one before it
+    foldLast();
+  }
+  runs_.push_back(run{offset, length, 0, 1, nullptr, nullptr});
+}
+
+void
+MpiPackPlan::foldLast()
+{
+  if (runs_.size() < 2) return;
+
+  run& last = runs_.back();
+  run& prev = runs_[runs_.size() - 2];
+  if (last.count != 1 || last.length != prev.length) return;
+
+  if (prev.count == 1){
+    prev.stride = last.offset - prev.offset;
+    prev.count = 2;
+    runs_.pop_back();
+  } else if (last.offset == prev.offset + prev.stride * prev.count){
+    ++prev.count;
+    runs_.pop_back();
+  }
+}
+
+}
@@ -0,0 +1,128 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#ifndef SSTMAC_SOFTWARE_LIBRARIES_MPI_MPI_TYPES_MPIPACKPLAN_H_INCLUDED
+#define SSTMAC_SOFTWARE_LIBRARIES_MPI_MPI_TYPES_MPIPACKPLAN_H_INCLUDED
+
+#include <sumi-mpi/mpi_types/mpi_type_fwd.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace sumi {
+
+/**
+ * @brief A datatype flattened into the list of copies needed to pack
+ * or unpack one element. Each run copies count blocks of length bytes
+ * whose unpacked addresses start at offset and advance by stride, while
+ * the packed side is always dense. Adjacent copies are merged and regular
+ * strides folded into a single run when the plan is compiled, and each run
+ * carries a copy kernel specialized for its block length.
+ */
+class MpiPackPlan
+{
+ public:
+  MpiPackPlan() : compiled_(false) {}
+
+  void compile(const MpiType* type);
+
+  bool compiled() const {
+    return compiled_;
+  }
+
+  /**
+   * @brief Whether one element is a single dense copy starting at its base address
+   */
+  bool dense() const {
+    return runs_.size() == 1 && runs_[0].offset == 0 && runs_[0].count == 1;
+  }
+
+  size_t numRuns() const {
+    return runs_.size();
+  }
+
+  void pack(const char* unpacked, char* packed) const {
+    for (const run& r : runs_){
+      (*r.gather)(packed, unpacked + r.offset, r.length, r.stride, r.count);
+      packed += r.length * r.count;
+    }
+  }
+
+  void unpack(const char* packed, char* unpacked) const {
+    for (const run& r : runs_){
+      (*r.scatter)(packed, unpacked + r.offset, r.length, r.stride, r.count);
+      packed += r.length * r.count;
+    }
+  }
+
+ private:
+  using gather_fxn = void(*)(char* packed, const char* unpacked,
+                             size_t length, ptrdiff_t stride, int count);
+  using scatter_fxn = void(*)(const char* packed, char* unpacked,
+                              size_t length, ptrdiff_t stride, int count);
+
+  struct run {
+    ptrdiff_t offset;
+    size_t length;
+    ptrdiff_t stride;
+    int count;
+    gather_fxn gather;
+    scatter_fxn scatter;
+  };
+
+  void flatten(const MpiType* type, ptrdiff_t offset);
+
+  void append(ptrdiff_t offset, size_t length);
+
+  void foldLast();
+
+  std::vector<run> runs_;
+
+  bool compiled_;
+
+};
+
+}
+
+#endif
@@ -304,139 +304,57 @@ MpiType::bytes_to_elements(size_t bytes) const
 void
 MpiType::pack(const void* inbuf, void *outbuf) const
 {
-  //we are packing from inbuf into outbuf
-  pack_action(outbuf, const_cast<void*>(inbuf), true);
-}
-
-void
-MpiType::unpack(const void* inbuf, void *outbuf) const
-{
-  //we are unpacking from inbuf into outbuf
-  //false = unpack
-  pack_action(const_cast<void*>(inbuf), outbuf, false);
-}
-
-void
-MpiType::pack_action_primitive(void* packed_buf, void* unpacked_buf, bool pack) const
-{
-  char* packed_ptr = (char*) packed_buf;
-  char* unpacked_ptr = (char*) unpacked_buf;
-  if (pack){
-    //copy into packed array
-    ::memcpy(packed_ptr, unpacked_ptr, size_);
-  } else {
-    //copy into unpacked array
-    ::memcpy(unpacked_ptr, packed_ptr, size_);
+  if (!plan_.compiled()){
+    spkt_abort_printf("MpiType::pack: type %s has not been committed", label.c_str());
   }
+  plan_.pack((const char*) inbuf, (char*) outbuf);
 }
 
 void
-MpiType::pack_action_vector(void* packed_buf, void* unpacked_buf, bool pack) const
-{
-  char* packed_ptr = (char*) packed_buf;
-  char* unpacked_ptr = (char*) unpacked_buf;
-  int packed_stride = vdata_->base->packed_size();
-  for (int j=0; j < vdata_->count; ++j){
-    char* this_unpacked_ptr = unpacked_ptr + vdata_->byte_stride * j;
-    vdata_->base->pack_action(packed_ptr, this_unpacked_ptr, pack);
-    packed_ptr += packed_stride;
-  }
-  unpacked_ptr += extent_;
-}
-
-void
-MpiType::pack_action_indexed(void* packed_buf, void* unpacked_buf, bool pack) const
+MpiType::unpack(const void* inbuf, void *outbuf) const
 {
-  char* packed_ptr = (char*) packed_buf;
-  char* unpacked_ptr = (char*) unpacked_buf;
-  for (int j=0; j < idata_->blocks.size(); ++j){
-    const ind_block& next_block = idata_->blocks[j];
-    int size = next_block.base->packed_size();
-    if (next_block.base->contiguous()){
-      char *src, *dst;
-      if (pack){ src = unpacked_ptr; dst = packed_ptr; }
-      else     { src = packed_ptr;   dst = unpacked_ptr; }
-      ::memcpy(dst, src, size*next_block.num);
-    } else {
-      if (pack) next_block.base->packSend(unpacked_ptr, packed_ptr, next_block.num);
-      else      next_block.base->unpack_recv(packed_ptr, unpacked_ptr, next_block.num);
-    }
-    packed_ptr += size*next_block.num;
-    unpacked_ptr += next_block.base->extent()*next_block.num;
+  if (!plan_.compiled()){
+    spkt_abort_printf("MpiType::unpack: type %s has not been committed", label.c_str());
   }
+  plan_.unpack((const char*) inbuf, (char*) outbuf);
 }
 
 void
 MpiType::packSend(void* srcbuf, void* dstbuf, int sendcnt)
 {
+  //base types used by value inside a derived type may never be committed
+  if (!plan_.compiled()) plan_.compile(this);
+
   char* src = (char*) srcbuf;
   char* dst = (char*) dstbuf;
+  if (plan_.dense() && extent_ == size_){
+    ::memcpy(dst, src, size_t(size_) * sendcnt);
+    return;
+  }
+
   int src_stride = extent_;
   int dst_stride = size_;
   for (int i=0; i < sendcnt; ++i, src += src_stride, dst += dst_stride){
-    pack(src, dst);
+    plan_.pack(src, dst);
   }
 }
 
 void
 MpiType::unpack_recv(void *srcbuf, void *dstbuf, int recvcnt)
 {
+  if (!plan_.compiled()) plan_.compile(this);
+
   char* src = (char*) srcbuf;
   char* dst = (char*) dstbuf;
+  if (plan_.dense() && extent_ == size_){
+    ::memcpy(dst, src, size_t(size_) * recvcnt);
+    return;
+  }
+
   int src_stride = size_;
   int dst_stride = extent_;
   for (int i=0; i < recvcnt; ++i, src += src_stride, dst += dst_stride){
-    unpack(src, dst);
-  }
-}
-
-void
-MpiType::pack_action_pair(void* packed_buf, void* unpacked_buf, bool pack) const
-{
-  int bytes_done = 0;
-  int first_size = pdata_->base1->size_;
-  int second_size = pdata_->base2->size_;
-  int pair_alignment = first_size;
-
-  char* packed_ptr = (char*) packed_buf;
-  char* unpacked_ptr = (char*) unpacked_buf;
-
-  if (pack){
-    ::memcpy(packed_ptr, unpacked_ptr, first_size);
-    ::memcpy(packed_ptr + first_size, unpacked_ptr + pair_alignment, second_size);
-  } else {
-    ::memcpy(unpacked_ptr, packed_ptr, first_size);
-    ::memcpy(unpacked_ptr + pair_alignment, packed_ptr + first_size, second_size);
-  }
-  unpacked_ptr += extent_;
-  packed_ptr += size_;
-  bytes_done += (first_size + second_size);
-}
-
-void
-MpiType::pack_action(void* packed_buf, void* unpacked_buf, bool pack) const
-{
-  switch(type_)
-  {
-  case PRIM: {
-    pack_action_primitive(packed_buf, unpacked_buf, pack);
-    break;
-  }
-  case PAIR: {
-    pack_action_pair(packed_buf, unpacked_buf, pack);
-    break;
-  }
-  case VEC: {
-    pack_action_vector(packed_buf, unpacked_buf, pack);
-    break;
-  }
-  case IND: {
-    pack_action_indexed(packed_buf, unpacked_buf, pack);
-    break;
-  }
-  case NONE: {
-    sprockit::abort("mpi_type::pack_action: cannot pack NONE type");
-  }
+    plan_.unpack(src, dst);
   }
 }
 
@@ -48,6 +48,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sumi/comm_functions.h>
 #include <sumi-mpi/mpi_integers.h>
 #include <sumi-mpi/mpi_types.h>
+#include <sumi-mpi/mpi_types/mpi_pack_plan.h>
 #include <unordered_map>
 #include <vector>
 #include <string>
@@ -77,6 +78,8 @@ using sumi::Max;
 /// MPI datatypes.
 class MpiType
 {
+  friend class MpiPackPlan;
+
  public:
   enum TYPE_TYPE {
     PRIM, PAIR, VEC, IND, NONE
@@ -144,8 +147,12 @@ class MpiType
 
   void unpack(const void *inbuf, void *outbuf) const;
 
+  /**
+   * @brief set_committed Committing a type compiles its pack plan
+   */
   void set_committed(bool flag){
     committed_ = flag;
+    if (flag && !plan_.compiled()) plan_.compile(this);
   }
 
   bool committed() const {
@@ -266,18 +273,6 @@ class MpiType
   static MpiType::ptr mpi_uint64_t;
   static MpiType::ptr mpi_cxx_bool;
 
- private:
-  void pack_action(void* packed_buf, void* unpacked_buf, bool pack) const;
-
-  void pack_action_primitive(void* packed_buf, void* unpacked_buf, bool pack) const;
-
-  void pack_action_pair(void* packed_buf, void* unpacked_buf, bool pack) const;
-
-  void pack_action_vector(void* packed_buf, void* unpacked_buf, bool pack) const;
-
-  void pack_action_indexed(void* packed_buf, void* unpacked_buf, bool pack) const;
-
-
  private:
   TYPE_TYPE type_;
 
@@ -293,6 +288,8 @@ class MpiType
 
   int size_; //this is the packed size !!!
   size_t extent_; //holds the extent, as defined by the MPI standard
+
+  MpiPackPlan plan_;
 };
 
 struct pairdata
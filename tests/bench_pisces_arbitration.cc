@@ -0,0 +1,116 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+
+/**
+ * Stress benchmark for the pisces cut-through arbitrator. One link is
+ * offered exactly 100% load with packets whose arrival rates vary, which
+ * fragments the link's idle epochs. Reports arbitrations per second and
+ * a checksum of the computed head/tail times so timing changes are visible.
+ *   bench_pisces_arbitration [packets]
+ */
+
+#include <sstmac/hardware/pisces/pisces_arbitrator.h>
+#include <sstmac/hardware/pisces/pisces.h>
+#include <sstmac/common/timestamp.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace sstmac;
+using namespace sstmac::hw;
+
+static const uint32_t packet_size = 1024;
+static const double link_bw = 10e9;
+
+static void
+benchmark(const char* label, long num_packets, int burst,
+          const std::vector<int>& slowdowns)
+{
+  PiscesBandwidthArbitrator* arb = sprockit::create<PiscesBandwidthArbitrator>(
+        "macro", "cut_through", link_bw);
+  PiscesPacket* pkt = new PiscesPacket(nullptr, packet_size, 0, false, 0, 1);
+  TimeDelta service_time = packet_size * arb->byteDelay();
+
+  uint64_t lcg = 42;
+  uint64_t checksum = 0;
+  Timestamp now;
+  auto start = std::chrono::steady_clock::now();
+  for (long i=0; i < num_packets; ++i){
+    lcg = lcg * 6364136223846793005ULL + 1442695040888963407ULL;
+    int slowdown = slowdowns[(lcg >> 33) % slowdowns.size()];
+    pkt->setByteDelay(slowdown * arb->byteDelay());
+
+    PiscesBandwidthArbitrator::IncomingPacket st;
+    st.now = now;
+    st.pkt = pkt;
+    st.incoming_byte_delay = pkt->byteDelay();
+    arb->arbitrate(st);
+    checksum += (st.head_leaves - now).ticks() + (st.tail_leaves - now).ticks();
+
+    //a burst of packets arrives together, then the link gets one
+    //service time per packet in the burst: 100% offered load
+    if ((i+1) % burst == 0){
+      now += burst * service_time;
+    }
+  }
+  auto stop = std::chrono::steady_clock::now();
+  double secs = std::chrono::duration<double>(stop - start).count();
+  printf("%-32s %10.3e arbitrations/s  checksum=%llu\n",
+         label, num_packets / secs, (unsigned long long) checksum);
+  delete pkt;
+  delete arb;
+}
+
+int main(int argc, char** argv)
+{
+  long num_packets = argc > 1 ? atol(argv[1]) : 1000000;
+  TimeDelta::initStamps(100);
+
+  benchmark("matched arrivals", num_packets, 1, {1});
+  benchmark("slow arrivals (1x/3x)", num_packets, 1, {1,3});
+  benchmark("bursts of 8 (1x/2x/4x)", num_packets, 8, {1,2,4});
+  benchmark("bursts of 32 (1x-8x)", num_packets, 32, {1,2,3,4,8});
+  return 0;
+}
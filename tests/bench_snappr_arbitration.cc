@@ -0,0 +1,152 @@
+/**
+Copyright 2009-2020 National Technology and Engineering Solutions of Sandia, 
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S.  Government 
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly 
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of 
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2020, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+
+/**
+ * Microbenchmark for snappr port arbitration. Each virtual lane is kept
+ * backlogged while packets are popped and reinserted in steady state,
+ * so the reported time is the arbitration cost per packet sent.
+ *   bench_snappr_arbitration [packets]
+ */
+
+#include <sstmac/hardware/snappr/snappr_outport.h>
+#include <sstmac/common/timestamp.h>
+#include <sprockit/sim_parameters.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace sstmac;
+using namespace sstmac::hw;
+
+static const uint32_t packet_size = 1024;
+static const int packets_per_vl = 16;
+
+static void
+benchmark(const char* label, const std::string& arb_name, int num_vls,
+          SST::Params& params, long num_packets)
+{
+  TimeDelta byte_delay(1e-9);
+  std::vector<int> vls_per_qos(num_vls, 1);
+  SnapprPortArbitrator* arb = sprockit::create<SnapprPortArbitrator>(
+        "macro", arb_name, byte_delay, params, vls_per_qos);
+  std::vector<uint32_t> credits(num_vls, packets_per_vl*packet_size);
+  arb->setVirtualLanes(credits);
+
+  uint64_t cycle = 0;
+  std::vector<SnapprPacket*> packets;
+  for (int vl=0; vl < num_vls; ++vl){
+    for (int p=0; p < packets_per_vl; ++p){
+      SnapprPacket* pkt = new SnapprPacket(nullptr, packet_size, false, vl, 0, 0, 0, vl);
+      pkt->setVirtualLane(vl);
+      arb->insert(cycle, pkt);
+      packets.push_back(pkt);
+    }
+  }
+
+  uint64_t pkt_cycles = packet_size * byte_delay.ticks();
+  std::vector<long> sent(num_vls, 0);
+  auto start = std::chrono::steady_clock::now();
+  for (long i=0; i < num_packets; ++i){
+    SnapprPacket* pkt = arb->pop(cycle);
+    cycle += pkt_cycles;
+    sent[pkt->virtualLane()]++;
+    arb->addCredits(pkt->virtualLane(), pkt->numBytes());
+    arb->insert(cycle, pkt);
+  }
+  auto stop = std::chrono::steady_clock::now();
+  double ns = std::chrono::duration<double,std::nano>(stop - start).count();
+
+  printf("%-24s %8.1f ns/packet", label, ns / num_packets);
+  if (num_vls <= 8){
+    printf("  VL shares:");
+    for (int vl=0; vl < num_vls; ++vl){
+      printf(" %5.3f", double(sent[vl]) / num_packets);
+    }
+  }
+  printf("\n");
+
+  for (SnapprPacket* pkt : packets){
+    delete pkt;
+  }
+  delete arb;
+}
+
+int main(int argc, char** argv)
+{
+  long num_packets = argc > 1 ? atol(argv[1]) : 2000000;
+  TimeDelta::initStamps(100);
+
+  {
+    SST::Params params;
+    benchmark("fifo, 1 VL", "fifo", 1, params, num_packets);
+  }
+  {
+    SST::Params params;
+    benchmark("fifo, 4 VLs", "fifo", 4, params, num_packets);
+  }
+  {
+    SST::Params params;
+    params.insert("vl_weights", "[0.25,0.25,0.5]");
+    benchmark("wrr min, 3 VLs", "wrr", 3, params, num_packets);
+  }
+  {
+    SST::Params params;
+    params.insert("vl_types", "[none,min,max,min,min,max,none,min]");
+    params.insert("vl_weights", "[0,0.1,0.5,0.1,0.1,0.25,0,0.2]");
+    params.insert("vl_priorities", "[0,0,2,1,1,2,0,1]");
+    benchmark("wrr mixed QoS, 8 VLs", "wrr", 8, params, num_packets);
+  }
+  {
+    SST::Params params;
+    std::string weights = "[";
+    for (int vl=0; vl < 32; ++vl){
+      weights += vl ? ",0.03" : "0.03";
+    }
+    weights += "]";
+    params.insert("vl_weights", weights);
+    benchmark("wrr min, 32 VLs", "wrr", 32, params, num_packets);
+  }
+  return 0;
+}